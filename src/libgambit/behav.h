@@ -31,12 +31,35 @@ namespace Gambit {
 /// MixedBehavProfile<T> implements a randomized behavior profile on
 /// an extensive game.
 ///
+/// Realization probabilities, beliefs and values are computed lazily
+/// and cached.  Changes to individual action probabilities only mark
+/// the information set they belong to; when next a cached quantity is
+/// requested, only the subtrees below and the paths above the members
+/// of the marked information sets are re-evaluated.  Any number of
+/// changes made between requests are thus applied together.
+///
 template <class T> class MixedBehavProfile : public DVector<T>  {
 protected:
   BehavSupport m_support;
 
   mutable bool m_cacheValid;
 
+  // structures for tracking changes since the cache was computed:
+  // information sets are numbered with those of the personal players
+  // first, in the order of the profile, followed by those of chance
+  Array<GameTreeInfosetRep *> m_infosets;
+  Array<int> m_entryInfoset;
+  mutable Array<int> m_infosetMarks, m_marked;
+  mutable int m_numMarked;
+  mutable Array<bool> m_nodeStale;
+
+  // the flat tree the cached data are computed on, and, for each node,
+  // the entry of the profile giving the probability of the move into
+  // it: zero if the action is not in the support, and negative if it
+  // is a chance move
+  mutable const CompiledTree<T> *m_tree;
+  Array<int> m_moveEntry;
+
   // structures for storing cached data: nodes
   mutable Vector<T> m_realizProbs, m_beliefs, m_nvals, m_bvals;
   mutable Matrix<T> m_nodeValues;
@@ -59,13 +82,33 @@ protected:
   
   /// @name Auxiliary functions for computation of interesting values
   //@{
-  void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
+  void GetPayoff(int, const T &, int, T &) const;
+  /// The probability of the move leading to node n in m_tree
+  T MoveProb(int n) const
+    { return ((m_moveEntry[n] > 0) ? Array<T>::operator[](m_moveEntry[n]) :
+	      ((m_moveEntry[n] < 0) ? m_tree->GetMoveProb(n) : (T) 0)); }
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  void ComputeSolutionDataPass2(void) const;
+  void ComputeSolutionDataPass1(int n) const;
+  void UpdateSolutionDataPass2(int n) const;
+  void UpdateSolutionDataPass1(int n) const;
+  void ComputeNodeValues(int n) const;
+  void ComputeInfosetData(int k) const;
   void ComputeSolutionData(void) const;
   //@}
 
+  /// @name Tracking changes to the profile
+  //@{
+  void InitChangeTracking(void);
+  void MarkInfoset(int p_index, int p_mark) const
+    { if (m_infosetMarks[p_index] == 0) {
+	m_infosetMarks[p_index] = p_mark;  m_marked[++m_numMarked] = p_index;
+      } }
+  /// Records that probabilities at the p_index'th information set changed
+  void InvalidateInfoset(int p_index) const
+    { if (m_cacheValid) MarkInfoset(p_index, 1); }
+  //@}
+
   /// @name Converting mixed strategies to behavior
   //@{
   void BehaviorStrat(int, GameTreeNodeRep *);
@@ -113,11 +156,12 @@ public:
   const T &operator()(int a, int b, int c) const
     { return DVector<T>::operator()(a, b, c); }
   T &operator()(int a, int b, int c) 
-    { Invalidate();  return DVector<T>::operator()(a, b, c); }
+    { InvalidateInfoset(this->dvidx[a] + b - 1);
+      return DVector<T>::operator()(a, b, c); }
   const T &operator[](int a) const
     { return Array<T>::operator[](a); }
   T &operator[](int a)
-    { Invalidate();  return Array<T>::operator[](a); }
+    { InvalidateInfoset(m_entryInfoset[a]);  return Array<T>::operator[](a); }
 
   MixedBehavProfile<T> &operator+=(const MixedBehavProfile<T> &x)
     { Invalidate();  DVector<T>::operator+=(x);  return *this; }
@@ -133,6 +177,10 @@ public:
   //@{
   /// Force recomputation of stored quantities
   void Invalidate(void) const { m_cacheValid = false; }
+  /// Assign all action probabilities at once.  Unlike operator=, only
+  /// the information sets whose probabilities differ are marked as
+  /// changed, so stored quantities are brought up to date incrementally.
+  void SetActionProbs(const Vector<T> &p_probs);
   /// Set the profile to the centroid
   void Centroid(void);
   //@}
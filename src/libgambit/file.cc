@@ -20,13 +20,16 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <cstdio>
 #include <cstdlib>
 #include <cctype>
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <vector>
 
 #include "libgambit.h"
+#include "gametable.h"
 
 namespace {
 // This anonymous namespace encapsulates the file-parsing code
@@ -43,189 +46,147 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! The file is read in large blocks, and tokens are assembled directly
+//! from the block in memory, reusing the same text buffer throughout.
+//!
 class GameParserState {
 private:
   std::istream &m_file;
+  /// The block of the file last read; the characters from m_position
+  /// up to m_length have not yet been tokenized
+  std::vector<char> m_buffer;
+  std::streamsize m_position, m_length;
 
   int m_currentLine;
   GameFileToken m_lastToken;
   std::string m_lastText;
 
+  /// Reads the next block of the file; returns false at its end
+  bool ReadBlock(void);
+  /// Returns the next character, without consuming it, or EOF
+  int PeekChar(void)
+  { return (m_position < m_length || ReadBlock()) ? 
+      (unsigned char) m_buffer[m_position] : EOF; }
+  /// Consumes the next character
+  void SkipChar(void)  { m_position++; }
+  /// Consumes the next character, appending it to the text of the token
+  void TakeChar(void)  { m_lastText += m_buffer[m_position++]; }
+  /// Consumes any digits which follow, appending them to the text
+  void TakeDigits(void)  { while (isdigit(PeekChar())) TakeChar(); }
+
 public:
   GameParserState(std::istream &p_file) : 
-    m_file(p_file), m_currentLine(1) { }
+    m_file(p_file), m_buffer(65536), m_position(0), m_length(0),
+    m_currentLine(1) { }
 
   GameFileToken GetNextToken(void);
   GameFileToken GetCurrentToken(void) const { return m_lastToken; }
   int GetCurrentLine(void) const { return m_currentLine; }
   const std::string &GetLastText(void) const { return m_lastText; }
+
+  /// Returns the text read from the file, but not yet tokenized
+  std::string GetUnreadText(void) const
+  { return std::string(&m_buffer[0] + m_position, m_length - m_position); }
 };  
 
-GameFileToken GameParserState::GetNextToken(void)
+bool GameParserState::ReadBlock(void)
 {
-  char c = ' '; 
-  if (m_file.eof()) {
-    return (m_lastToken = TOKEN_EOF);
+  if (!m_file.good()) {
+    return false;
   }
+  m_file.read(&m_buffer[0], m_buffer.size());
+  m_position = 0;
+  m_length = m_file.gcount();
+  return (m_length > 0);
+}
 
+GameFileToken GameParserState::GetNextToken(void)
+{
+  int c = PeekChar();
   while (isspace(c)) {
-    m_file.get(c);
-    if (!m_file.good()) {
-      return (m_lastToken = TOKEN_EOF);
-    } 
-    else if (c == '\n') {
+    if (c == '\n') {
       m_currentLine++;
     }
+    SkipChar();
+    c = PeekChar();
   }
 
-  if (c == '{') {
+  if (c == EOF) {
+    return (m_lastToken = TOKEN_EOF);
+  }
+  else if (c == '{') {
+    SkipChar();
     return (m_lastToken = TOKEN_LBRACE);
   }
   else if (c == '}') {
+    SkipChar();
     return (m_lastToken = TOKEN_RBRACE);
   }
   else if (c == ',') {
+    SkipChar();
     return (m_lastToken = TOKEN_COMMA);
   }
-  else if (isdigit(c) || c == '-' || c == '+') {
-    std::string buf;
-    buf += c;
-    m_file.get(c);
-
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
-      buf += c;
-      m_file.get(c);
-    }
-    
-    if (m_file.eof() || !m_file.good()) {
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }      
-
-    if (c == '.') {
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-      	buf += c;
-      	m_file.get(c);
-      }
-
-      if (c == 'e' || c == 'E') {
-	buf += c;
-	m_file.get(c);
-	if (c == '+' && c == '-' && !isdigit(c)) {
-	  throw InvalidFileException();
-	}
-	buf += c;
-	m_file.get(c);
-	while (isdigit(c)) {
-	  buf += c;
-	  m_file.get(c);
-	}
-      }
-
-      m_file.unget();
-      m_lastText = buf;
 
+  m_lastText.clear();
+  if (isdigit(c) || c == '-' || c == '+') {
+    TakeChar();
+    TakeDigits();
+    if (PeekChar() == '/') {
+      TakeChar();
+      TakeDigits();
       return (m_lastToken = TOKEN_NUMBER);
     }
-    else if (c == '/') {
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-      	buf += c;
-      	m_file.get(c);
-      }
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
+    if (PeekChar() == '.') {
+      TakeChar();
+      TakeDigits();
     }
-    else if (c == 'e' || c == 'E') {
-      buf += c;
-      m_file.get(c);
-      if (c == '+' && c == '-' && !isdigit(c)) {
-	throw InvalidFileException();
+    if (PeekChar() == 'e' || PeekChar() == 'E') {
+      TakeChar();
+      // The sign or first digit of the exponent
+      if (PeekChar() != EOF) {
+	TakeChar();
       }
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-	buf += c;
-	m_file.get(c);
-      }
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else {
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
+      TakeDigits();
     }
+    return (m_lastToken = TOKEN_NUMBER);
   }
   else if (c == '.') {
-    std::string buf;
-    buf += c;
-    m_file.get(c);
-    
-    while (isdigit(c)) {
-      buf += c;
-      m_file.get(c);
-    }
-    m_file.unget();
-    m_lastText = buf;
+    TakeChar();
+    TakeDigits();
     return (m_lastToken = TOKEN_NUMBER);
   }
-
   else if (c == '"') {
     // We need to do a little magic here, since escaped quotes inside
     // the string are treated as quotes (not end-of-string)
-    m_file.unget();
-    char a;
-  
-    m_lastText = "";
-  
-    do  {
-      m_file.get(a);
-      if (isspace(a) && a=='\n') {
-        m_currentLine++;
+    SkipChar();
+    bool lastslash = false;
+    while ((c = PeekChar()) != '"' || lastslash) {
+      if (c == EOF) {
+	throw InvalidFileException();
       }
-    }  while (isspace(a));
-
-    if (a == '\"')  {
-      bool lastslash = false;
-
-      m_file.get(a);
-      while  (a != '\"' || lastslash)  {
-      	if (lastslash && a == '"')  
-      	  m_lastText += '"';
-      	else if (lastslash)  {
-      	  m_lastText += '\\';
-      	  m_lastText += a;
-      	}
-      	else if (a != '\\')
-      	  m_lastText += a;
-      	
-      	lastslash = (a == '\\');
-      	m_file.get(a);
+      else if (c == '\n') {
+	m_currentLine++;
       }
+      SkipChar();
+      if (lastslash && c == '"') {
+	m_lastText += '"';
+      }
+      else if (lastslash) {
+	m_lastText += '\\';
+	m_lastText += (char) c;
+      }
+      else if (c != '\\') {
+	m_lastText += (char) c;
+      }
+      lastslash = (c == '\\');
     }
-    else  {
-      do  {
-      	m_lastText += a;
-      	m_file.get(a);
-        if (isspace(a) && a=='\n') {
-          m_currentLine++;
-        }
-      }  while (!isspace(a));
-    }
-
+    SkipChar();
     return (m_lastToken = TOKEN_TEXT);
   }
 
-  m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
-    m_lastText += c;
-    m_file.get(c);
+  while (c != EOF && !isspace(c)) {
+    TakeChar();
+    c = PeekChar();
   }
   return (m_lastToken = TOKEN_SYMBOL);
 }
@@ -546,21 +507,30 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
   }
 }
 
+//
+// In a newly-created table, the outcomes are numbered in the order of
+// the contingencies, which is the order in which payoffs are listed;
+// each payoff is stored directly in its outcome as it is read.
+//
 void ParsePayoffBody(GameParserState &p_parser, GameRep *p_nfg)
 {
-  StrategyIterator iter(StrategySupport(static_cast<GameRep *>(p_nfg)));
-  int pl = 1;
+  int numPlayers = p_nfg->NumPlayers(), numOutcomes = p_nfg->NumOutcomes();
+  GameOutcome outcome;
+  if (numOutcomes > 0) {
+    outcome = p_nfg->GetOutcome(1);
+  }
+  int outc = 1, pl = 1;
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
-    if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, p_parser.GetLastText());
-    }
-    else {
+    if (p_parser.GetCurrentToken() != TOKEN_NUMBER || outc > numOutcomes) {
       throw InvalidFileException();
     }
+    outcome->SetPayoff(pl, p_parser.GetLastText());
 
-    if (++pl > p_nfg->NumPlayers()) {
-      iter++;
+    if (++pl > numPlayers) {
+      if (++outc <= numOutcomes) {
+	outcome = p_nfg->GetOutcome(outc);
+      }
       pl = 1;
     }
     p_parser.GetNextToken();
@@ -933,6 +903,11 @@ namespace Gambit {
 
 Game ReadGame(std::istream &p_file) throw (InvalidFileException)
 {
+  // Binary files start with a byte which cannot begin a text file
+  if (p_file.peek() == 0177) {
+    return GameTableRep::ReadBinaryFile(p_file);
+  }
+
   GameParserState parser(p_file);
 
   try {
@@ -952,7 +927,14 @@ Game ReadGame(std::istream &p_file) throw (InvalidFileException)
       return game;
     }
     else if (parser.GetLastText() == "#AGG") {
-      return GameAggRep::ReadAggFile(p_file);
+      // The parser reads ahead; what it has not consumed is passed on
+      // together with the rest of the file
+      std::stringstream rest;
+      rest << parser.GetUnreadText();
+      if (p_file.good()) {
+	rest << p_file.rdbuf();
+      }
+      return GameAggRep::ReadAggFile(rest);
     }
     else {
       throw InvalidFileException("Tokens 'EFG' or 'NFG' expected at start of file");
@@ -45,6 +45,7 @@ GameOutcomeRep::GameOutcomeRep(GameRep *p_game, int p_number)
 
 void GameStrategyRep::DeleteStrategy(void)
 {
+  CheckMutable();
   if (m_player->GetGame()->IsTree())  throw UndefinedException();
   if (m_player->NumStrategies() == 1)  return;
 
@@ -78,6 +79,7 @@ GamePlayerRep::~GamePlayerRep()
 
 GameStrategy GamePlayerRep::NewStrategy(void)
 {
+  CheckMutable();
   if (m_game->IsTree())  throw UndefinedException();
 
   GameStrategyRep *strategy = new GameStrategyRep(this);
@@ -219,37 +221,44 @@ void PureBehavProfile::SetAction(const GameAction &action)
     [action->GetInfoset()->GetNumber()] = action;
 }
 
-template <class T> 
-T PureBehavProfile::GetPayoff(const GameNode &p_node,
-				 int pl) const
+template <class T>
+T PureBehavProfile::GetPayoff(const CompiledTree<T> &p_tree, 
+			      int n, int pl) const
 {
   T payoff(0);
 
-  GameTreeNodeRep *node = dynamic_cast<GameTreeNodeRep *>(p_node.operator->());
-
-  if (node->outcome) {
-    payoff += node->outcome->GetPayoff<T>(pl);
+  if (p_tree.HasOutcome(n)) {
+    payoff += p_tree.GetPayoff(n, pl);
   }
 
-  if (!node->IsTerminal()) {
-    if (node->GetInfoset()->IsChanceInfoset()) {
-      for (int i = 1; i <= node->NumChildren(); i++) {
-	GameTreeInfosetRep *infoset = node->infoset;
-	payoff += (infoset->GetActionProb(i, (T) 0) *
-		   GetPayoff<T>(node->children[i], pl));
+  int infoset = p_tree.GetInfoset(n);
+  if (infoset) {
+    int player = p_tree.GetInfosetPlayer(infoset);
+    if (player == 0) {
+      for (int i = 1; i <= p_tree.NumChildren(n); i++) {
+	int child = p_tree.GetChild(n, i);
+	payoff += p_tree.GetMoveProb(child) * GetPayoff(p_tree, child, pl);
       }
     }
     else {
-      int player = node->GetPlayer()->GetNumber();
-      int iset = node->GetInfoset()->GetNumber();
-      payoff += GetPayoff<T>(node->children[m_profile[player][iset]->GetNumber()], 
-				pl);
+      int iset = p_tree.GetInfosetNumber(infoset);
+      payoff += GetPayoff(p_tree, 
+			  p_tree.GetChild(n, m_profile[player][iset]->GetNumber()),
+			  pl);
     }
   }
 
   return payoff;
 }
 
+template <class T> 
+T PureBehavProfile::GetPayoff(const GameNode &p_node,
+				 int pl) const
+{
+  const GameTreeRep *efg = dynamic_cast<const GameTreeRep *>(m_efg.operator->());
+  return GetPayoff(efg->GetCompiledTree<T>(), p_node->GetNumber(), pl);
+}
+
 // Explicit instantiations
 template double PureBehavProfile::GetPayoff(const GameNode &, int pl) const;
 template Rational PureBehavProfile::GetPayoff(const GameNode &, int pl) const;
@@ -282,6 +291,33 @@ GameExplicitRep::~GameExplicitRep()
        m_outcomes[outc++]->Invalidate());
 }
 
+//------------------------------------------------------------------------
+//              GameExplicitRep: Sharing the game between threads
+//------------------------------------------------------------------------
+
+void GameExplicitRep::Freeze(void)
+{
+  if (m_frozen)  return;
+
+  BuildComputedValues();
+
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = m_outcomes[outc];
+    for (int pl = 1; pl <= outcome->m_payoffs.Length(); 
+	 outcome->m_payoffs[pl++].Materialize());
+    outcome->MarkFrozen();
+  }
+
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    for (int st = 1; st <= player->m_strategies.Length(); 
+	 player->m_strategies[st++]->MarkFrozen());
+    player->MarkFrozen();
+  }
+
+  MarkFrozen();
+}
+
 //------------------------------------------------------------------------
 //                  GameExplicitRep: General data access
 //------------------------------------------------------------------------
@@ -387,6 +423,7 @@ int GameExplicitRep::MixedProfileLength(void) const
 
 GameOutcome GameExplicitRep::NewOutcome(void)
 {
+  CheckMutable();
   m_outcomes.Append(new GameOutcomeRep(this, m_outcomes.Length() + 1));
   return m_outcomes[m_outcomes.Last()];
 }
@@ -406,6 +443,9 @@ void GameExplicitRep::Write(std::ostream &p_stream,
 	   (p_format == "native" && !IsTree())) {
     WriteNfgFile(p_stream);
   }
+  else if (p_format == "binary") {
+    WriteBinaryFile(p_stream);
+  }
   else {
     throw UndefinedException();
   }
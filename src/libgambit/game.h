@@ -28,6 +28,20 @@
 #include "dvector.h"
 #include "number.h"
 
+#if defined(__GNUC__)
+#define GAMBIT_ATOMIC_INCREMENT(x) __sync_add_and_fetch(&(x), 1)
+#define GAMBIT_ATOMIC_DECREMENT(x) __sync_sub_and_fetch(&(x), 1)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define GAMBIT_ATOMIC_INCREMENT(x) _InterlockedIncrement((long *) &(x))
+#define GAMBIT_ATOMIC_DECREMENT(x) _InterlockedDecrement((long *) &(x))
+#else
+// No atomic operations are known for this compiler; frozen games
+// can then only be shared by threads which serialize their handle copies.
+#define GAMBIT_ATOMIC_INCREMENT(x) (++(x))
+#define GAMBIT_ATOMIC_DECREMENT(x) (--(x))
+#endif
+
 namespace Gambit {
 
 /// This is a base class for all game-related objects.  Primary among
@@ -39,16 +53,23 @@ namespace Gambit {
 /// but will instead be marked as deleted.  Calling code should always
 /// be careful to check the deleted status of the object before any
 /// operations on it.
+///
+/// Objects belonging to a frozen game (see GameRep::Freeze()) are
+/// read-only, and maintain their reference counts atomically, so that
+/// handles to them may be copied and released from several threads.
 class GameObject {
 protected:
   int m_refCount;
-  bool m_valid;
+  bool m_valid, m_frozen;
+
+  /// Throws FrozenGameException if the object belongs to a frozen game
+  void CheckMutable(void) const;
 
 public:
   /// @name Lifecycle
   //@{
   /// Constructor; initializes reference count
-  GameObject(void) : m_refCount(0), m_valid(true) { }
+  GameObject(void) : m_refCount(0), m_valid(true), m_frozen(false) { }
   /// Destructor
   virtual ~GameObject() { }
   //@}
@@ -60,14 +81,23 @@ public:
   /// Invalidate the object; delete if not referenced elsewhere
   void Invalidate(void)
   { if (!m_refCount) delete this; else m_valid = false; }
+  /// Is the object part of a frozen, read-only game?
+  bool IsFrozen(void) const { return m_frozen; }
+  /// Mark the object as read-only; this cannot be undone.  Calling
+  /// code should freeze whole games, using GameRep::Freeze().
+  void MarkFrozen(void) { m_frozen = true; }
   //@}
 
   /// @name Reference counting
   //@{
   /// Increment the reference count
-  void IncRef(void) { m_refCount++; }
+  void IncRef(void) 
+  { if (m_frozen) GAMBIT_ATOMIC_INCREMENT(m_refCount); else m_refCount++; }
   /// Decrement the reference count; delete if reference count is zero.
-  void DecRef(void) { if (!--m_refCount && !m_valid) delete this; }
+  /// A frozen object is never invalidated, and so is never deleted here.
+  void DecRef(void)
+  { if (m_frozen) GAMBIT_ATOMIC_DECREMENT(m_refCount);
+    else if (!--m_refCount && !m_valid) delete this; }
   /// Returns the reference count
   int RefCount(void) const { return m_refCount; }
   //@}
@@ -80,6 +110,16 @@ public:
   const char *what(void) const throw()  { return "Dereferencing an invalidated object"; }
 };
 
+/// An exception thrown when attempting to modify a frozen game
+class FrozenGameException : public Exception {
+public:
+  virtual ~FrozenGameException() throw() { }
+  const char *what(void) const throw()  { return "Modifying a frozen game"; }
+};
+
+inline void GameObject::CheckMutable(void) const
+{ if (m_frozen) throw FrozenGameException(); }
+
 
 //
 // This is a handle class that is used by all calling code to refer to
@@ -194,6 +234,7 @@ typedef std::auto_ptr<PureStrategyProfileRep> PureStrategyProfile;
 //
 template <class T> class MixedStrategyProfile;
 template <class T> class MixedBehavProfile;
+template <class T> class CompiledTree;
 class StrategySupport;
 
 //=======================================================================
@@ -262,17 +303,14 @@ public:
   /// Returns the text label associated with the outcome
   const std::string &GetLabel(void) const { return m_label; }
   /// Sets the text label associated with the outcome 
-  void SetLabel(const std::string &p_label) { m_label = p_label; }
+  void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
 
   /// Gets the payoff associated with the outcome to player 'pl'
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
   //@}
 };
 
@@ -356,6 +394,7 @@ class GameStrategyRep : public GameObject  {
   friend class TablePureStrategyProfileRep;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
+  template <class T> friend class TreeMixedStrategyProfileRep;
   template <class T> friend class MixedBehavProfile;
 
 private:
@@ -378,7 +417,8 @@ public:
   /// Returns the text label associated with the strategy
   const std::string &GetLabel(void) const { return m_label; }
   /// Sets the text label associated with the strategy
-  void SetLabel(const std::string &p_label) { m_label = p_label; }
+  void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
   
   /// Returns the player for whom this is a strategy
   GamePlayer GetPlayer(void) const;
@@ -427,7 +467,8 @@ public:
   Game GetGame(void) const;
   
   const std::string &GetLabel(void) const { return m_label; }
-  void SetLabel(const std::string &p_label) { m_label = p_label; }
+  void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
   
   bool IsChance(void) const { return (m_number == 0); }
 
@@ -555,6 +596,8 @@ private:
   Game m_efg;
   Array<Array<GameAction> > m_profile;
 
+  template <class T> T GetPayoff(const CompiledTree<T> &, int n, int pl) const;
+
 public:
   /// @name Lifecycle
   //@{
@@ -584,6 +627,7 @@ public:
 
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public GameObject {
+  friend class GameOutcomeRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -608,6 +652,8 @@ protected:
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return false; }
+  /// Discard any cached tables built from the outcomes' payoffs
+  virtual void ClearPayoffTables(void) const { }
   //@}
 
 
@@ -620,6 +666,20 @@ public:
   virtual Game Copy(void) const = 0;
   //@}
 
+  /// @name Sharing the game between threads
+  //@{
+  /// Make the game and all its objects read-only, so that the game may
+  /// be used from several threads at once.  Everything otherwise
+  /// computed on demand (the reduced strategic form, payoff tables,
+  /// compiled trees, and exact values of payoffs and probabilities)
+  /// is built here, so that afterwards no member function reached
+  /// through a handle modifies any data; any attempt to change the game
+  /// throws FrozenGameException.  Freezing cannot be undone; Copy()
+  /// returns a modifiable game.  The thread which freezes the game
+  /// should keep a handle to it until the other threads are done.
+  virtual void Freeze(void) { throw UndefinedException(); }
+  //@}
+
   /// @name General data access
   //@{
   /// Returns true if the game has a game tree representation
@@ -631,12 +691,14 @@ public:
   /// Get the text label associated with the game
   virtual const std::string &GetTitle(void) const { return m_title; }
   /// Set the text label associated with the game
-  virtual void SetTitle(const std::string &p_title) { m_title = p_title; }
+  virtual void SetTitle(const std::string &p_title)
+  { CheckMutable(); m_title = p_title; }
 
   /// Get the text comment associated with the game
   virtual const std::string &GetComment(void) const { return m_comment; }
   /// Set the text comment associated with the game
-  virtual void SetComment(const std::string &p_comment) { m_comment = p_comment; }
+  virtual void SetComment(const std::string &p_comment)
+  { CheckMutable(); m_comment = p_comment; }
 
   /// Returns true if the game is constant-sum
   virtual bool IsConstSum(void) const = 0; 
@@ -655,7 +717,10 @@ public:
 
   /// @name Writing data files
   //@{
-  /// Write the game to a savefile in the specified format.
+  /// Write the game to a savefile in the specified format: "efg",
+  /// "nfg", "binary" (strategic games only; see
+  /// GameTableRep::WriteBinaryFile()), or "native" for the format in
+  /// which the game is represented.
   virtual void Write(std::ostream &p_stream,
 		     const std::string &p_format="native") const
   { throw UndefinedException(); }
@@ -734,7 +799,9 @@ typedef GameObjectPtr<GameRep> Game;
 
 /// Factory function to create new game tree
 Game NewTree(void);
-/// Factory function to create new game table
+/// Factory function to create new game table.  If p_sparseOutcomes is
+/// true, no contingency has an outcome initially, and only those later
+/// given outcomes take up memory (see GameTableRep::IsSparse()).
 Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 
 //=======================================================================
@@ -745,6 +812,13 @@ Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 // all classes to be defined.
 
 inline Game GameOutcomeRep::GetGame(void) const { return m_game; }
+inline void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  CheckMutable();
+  m_payoffs[pl] = p_value;
+  //m_game->ClearComputedValues();
+  m_game->ClearPayoffTables();
+}
 
 inline GamePlayer GameStrategyRep::GetPlayer(void) const { return m_player; }
 
@@ -41,6 +41,9 @@ protected:
   /// Write the game in .nfg format to the specified stream
   virtual void WriteNfgFile(std::ostream &) const
   { throw UndefinedException(); }
+  /// Write the game in binary format to the specified stream
+  virtual void WriteBinaryFile(std::ostream &) const
+  { throw UndefinedException(); }
   //@}
 
 public:
@@ -50,6 +53,13 @@ public:
   virtual ~GameExplicitRep();
   //@}
 
+  /// @name Sharing the game between threads
+  //@{
+  /// Build all computed values, and mark the game, its players,
+  /// strategies and outcomes as read-only
+  virtual void Freeze(void);
+  //@}
+
   /// @name General data access
   //@{
   /// Returns the smallest payoff in any outcome of the game
@@ -20,11 +20,14 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "libgambit.h"
 #include "gametable.h"
+#include "writer.h"
 
 namespace Gambit {
 
@@ -84,17 +87,20 @@ void TablePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 
 GameOutcome TablePureStrategyProfileRep::GetOutcome(void) const
 { 
-  return dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index]; 
+  return dynamic_cast<GameTableRep &>(*m_nfg).GetResult(m_index); 
 }
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
-  dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  GameTableRep &game = dynamic_cast<GameTableRep &>(*m_nfg);
+  if (game.IsFrozen())  throw FrozenGameException();
+  game.SetResult(m_index, p_outcome); 
+  game.ClearPayoffTables();
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index];
+  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).GetResult(m_index);
   if (outcome) {
     return outcome->GetPayoff<Rational>(pl);
   }
@@ -107,7 +113,7 @@ Rational
 TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
   int player = p_strategy->GetPlayer()->GetNumber();
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index - m_profile[player]->m_offset + p_strategy->m_offset];
+  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).GetResult(m_index - m_profile[player]->m_offset + p_strategy->m_offset);
   if (outcome) {
     return outcome->GetPayoff<Rational>(player);
   }
@@ -142,8 +148,14 @@ int Product(const Array<int> &dim)
   
 GameTableRep::GameTableRep(const Array<int> &dim, 
 			   bool p_sparseOutcomes /* = false */)
+  : m_sparse(p_sparseOutcomes),
+    m_hasDoublePayoffs(false), m_hasRationalPayoffs(false),
+    m_hasSparseOffsets(false),
+    m_hasSparseDoublePayoffs(false), m_hasSparseRationalPayoffs(false)
 {
-  m_results = Array<GameOutcomeRep *>(Product(dim));
+  if (!m_sparse) {
+    m_results = Array<GameOutcomeRep *>(Product(dim));
+  }
   for (int pl = 1; pl <= dim.Length(); pl++)  {
     m_players.Append(new GamePlayerRep(this, pl, dim[pl]));
     m_players[pl]->m_label = lexical_cast<std::string>(pl);
@@ -153,11 +165,7 @@ GameTableRep::GameTableRep(const Array<int> &dim,
   }
   IndexStrategies();
 
-  if (p_sparseOutcomes) {
-    for (int cont = 1; cont <= m_results.Length();
-	 m_results[cont++] = 0);
-  }
-  else {
+  if (!m_sparse) {
     m_outcomes = Array<GameOutcomeRep *>(m_results.Length());
     for (int i = 1; i <= m_outcomes.Length(); i++) {
       m_outcomes[i] = new GameOutcomeRep(this, i);
@@ -171,7 +179,67 @@ Game GameTableRep::Copy(void) const
   std::ostringstream os;
   WriteNfgFile(os);
   std::istringstream is(os.str());
-  return ReadGame(is);
+  Game game = ReadGame(is);
+  dynamic_cast<GameTableRep &>(*game).SetSparse(m_sparse);
+  return game;
+}
+
+//------------------------------------------------------------------------
+//           GameTableRep: Storage of the outcomes of contingencies
+//------------------------------------------------------------------------
+
+void GameTableRep::SetResult(long p_index, GameOutcomeRep *p_outcome)
+{
+  if (!m_sparse) {
+    m_results[p_index] = p_outcome;
+  }
+  else if (p_outcome) {
+    m_sparseResults[p_index] = p_outcome;
+  }
+  else {
+    m_sparseResults.erase(p_index);
+  }
+}
+
+void GameTableRep::SetSparse(bool p_sparse)
+{
+  if (p_sparse == m_sparse)  return;
+  CheckMutable();
+
+  if (p_sparse) {
+    for (int cont = 1; cont <= m_results.Length(); cont++) {
+      if (m_results[cont]) {
+	m_sparseResults.insert(m_sparseResults.end(),
+			       std::make_pair((long) cont, m_results[cont]));
+      }
+    }
+    m_results = Array<GameOutcomeRep *>();
+  }
+  else {
+    long size = 1L;
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      size *= m_players[pl]->m_strategies.Length();
+    }
+    m_results = Array<GameOutcomeRep *>(size);
+    for (int cont = 1; cont <= m_results.Length(); m_results[cont++] = 0);
+    for (std::map<long, GameOutcomeRep *>::const_iterator result =
+	   m_sparseResults.begin(); result != m_sparseResults.end(); ++result) {
+      m_results[result->first] = result->second;
+    }
+    m_sparseResults.clear();
+  }
+  m_sparse = p_sparse;
+  ClearPayoffTables();
+}
+
+long GameTableRep::NumResults(void) const
+{
+  if (m_sparse)  return m_sparseResults.size();
+  long count = 0L;
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    if (m_results[cont])  count++;
+  }
+  return count;
 }
 
 //------------------------------------------------------------------------
@@ -203,78 +271,489 @@ bool GameTableRep::IsConstSum(void) const
 }
 
 //------------------------------------------------------------------------
-//                   GameTableRep: Writing data files
+//             GameTableRep: Sharing the game between threads
 //------------------------------------------------------------------------
 
-namespace {
+void GameTableRep::Freeze(void)
+{
+  if (m_frozen)  return;
+
+  if (m_players.Length() > 0 && !m_sparse) {
+    GetPayoffTable<double>(1);
+    GetPayoffTable<Rational>(1);
+  }
+  else if (m_players.Length() > 0) {
+    // The full tables would take memory in proportion to the number of
+    // contingencies; they are built on demand (see GetPayoffTable())
+    GetSparsePayoffTable<double>(1);
+    GetSparsePayoffTable<Rational>(1);
+  }
+  GameExplicitRep::Freeze();
+}
+
+//------------------------------------------------------------------------
+//                 GameTableRep: Compiled payoff tables
+//------------------------------------------------------------------------
 
-std::string EscapeQuotes(const std::string &s)
+template <class T> 
+void GameTableRep::BuildPayoffTables(Array<Array<T> > &p_tables) const
 {
-  std::string ret;
-  
-  for (unsigned int i = 0; i < s.length(); i++)  {
-    if (s[i] == '"')   ret += '\\';
-    ret += s[i];
+  long size = 1L;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    size *= m_players[pl]->m_strategies.Length();
+  }
+  p_tables = Array<Array<T> >(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    Array<T> &payoffs = p_tables[pl];
+    payoffs = Array<T>(size);
+    for (int cont = 1; cont <= payoffs.Length(); cont++) {
+      GameOutcomeRep *outcome = GetResult(cont);
+      payoffs[cont] = (outcome) ? outcome->GetPayoff<T>(pl) : (T) 0;
+    }
+  }
+}
+
+template <class T> 
+void GameTableRep::BuildSparsePayoffTables(Array<Array<T> > &p_tables) const
+{
+  const Array<long> &offsets = GetSparseOffsets();
+  p_tables = Array<Array<T> >(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    Array<T> &payoffs = p_tables[pl];
+    payoffs = Array<T>(offsets.Length());
+    for (int i = 1; i <= offsets.Length(); i++) {
+      payoffs[i] = GetResult(offsets[i] + 1)->GetPayoff<T>(pl);
+    }
   }
+}
 
-  return ret;
+//
+// The full tables of a frozen game in sparse storage are not built on
+// freezing, so threads may ask for them at once; they are built in a
+// critical section.
+//
+template<> const Array<double> &GameTableRep::GetPayoffTable(int pl) const
+{
+  if (IsFrozen() && m_sparse) {
+#pragma omp critical(GambitFullPayoffTables)
+    if (!m_hasDoublePayoffs) {
+      BuildPayoffTables(m_doublePayoffs);
+      m_hasDoublePayoffs = true;
+    }
+  }
+  else if (!m_hasDoublePayoffs) {
+    BuildPayoffTables(m_doublePayoffs);
+    m_hasDoublePayoffs = true;
+  }
+  return m_doublePayoffs[pl];
 }
 
-}  // end anonymous namespace
+template<> const Array<Rational> &GameTableRep::GetPayoffTable(int pl) const
+{
+  if (IsFrozen() && m_sparse) {
+#pragma omp critical(GambitFullPayoffTables)
+    if (!m_hasRationalPayoffs) {
+      BuildPayoffTables(m_rationalPayoffs);
+      m_hasRationalPayoffs = true;
+    }
+  }
+  else if (!m_hasRationalPayoffs) {
+    BuildPayoffTables(m_rationalPayoffs);
+    m_hasRationalPayoffs = true;
+  }
+  return m_rationalPayoffs[pl];
+}
+
+const Array<long> &GameTableRep::GetSparseOffsets(void) const
+{
+  if (!m_hasSparseOffsets) {
+    m_sparseOffsets = Array<long>(NumResults());
+    if (m_sparse) {
+      int i = 1;
+      for (std::map<long, GameOutcomeRep *>::const_iterator result =
+	     m_sparseResults.begin(); result != m_sparseResults.end(); 
+	   ++result) {
+	m_sparseOffsets[i++] = result->first - 1;
+      }
+    }
+    else {
+      for (int cont = 1, i = 1; cont <= m_results.Length(); cont++) {
+	if (m_results[cont])  m_sparseOffsets[i++] = cont - 1;
+      }
+    }
+    m_hasSparseOffsets = true;
+  }
+  return m_sparseOffsets;
+}
+
+template<> const Array<double> &GameTableRep::GetSparsePayoffTable(int pl) const
+{
+  if (!m_hasSparseDoublePayoffs) {
+    BuildSparsePayoffTables(m_sparseDoublePayoffs);
+    m_hasSparseDoublePayoffs = true;
+  }
+  return m_sparseDoublePayoffs[pl];
+}
+
+template<> const Array<Rational> &GameTableRep::GetSparsePayoffTable(int pl) const
+{
+  if (!m_hasSparseRationalPayoffs) {
+    BuildSparsePayoffTables(m_sparseRationalPayoffs);
+    m_hasSparseRationalPayoffs = true;
+  }
+  return m_sparseRationalPayoffs[pl];
+}
+
+void GameTableRep::ClearPayoffTables(void) const
+{
+  m_doublePayoffs = Array<Array<double> >();
+  m_rationalPayoffs = Array<Array<Rational> >();
+  m_hasDoublePayoffs = m_hasRationalPayoffs = false;
+  m_sparseOffsets = Array<long>();
+  m_sparseDoublePayoffs = Array<Array<double> >();
+  m_sparseRationalPayoffs = Array<Array<Rational> >();
+  m_hasSparseOffsets = false;
+  m_hasSparseDoublePayoffs = m_hasSparseRationalPayoffs = false;
+}
+
+//------------------------------------------------------------------------
+//                   GameTableRep: Writing data files
+//------------------------------------------------------------------------
 
 void GameTableRep::WriteNfgFile(std::ostream &p_file) const
 { 
-  p_file << "NFG 1 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
+  GameFileWriter out(p_file);
+  out << "NFG 1 R ";
+  out.WriteQuoted(GetTitle());
+  out << " { ";
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    out.WriteQuoted(m_players[pl]->m_label);
+    out << ' ';
+  }
+  out << "}\n\n{ ";
+  
+  for (int pl = 1; pl <= m_players.Length(); pl++)   {
+    GamePlayerRep *player = m_players[pl];
+    out << "{ ";
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      out.WriteQuoted(player->m_strategies[st]->m_label);
+      out << ' ';
+    }
+    out << "}\n";
+  }
+  out << "}\n";
 
-  for (int i = 1; i <= NumPlayers(); i++)
-    p_file << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
+  out.WriteQuoted(m_comment);
+  out << "\n\n";
 
-  p_file << "}\n\n{ ";
-  
-  for (int i = 1; i <= NumPlayers(); i++)   {
-    GamePlayerRep *player = GetPlayer(i);
-    p_file << "{ ";
-    for (int j = 1; j <= player->NumStrategies(); j++)
-      p_file << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
-    p_file << "}\n";
+  out << "{\n";
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++)   {
+    out << "{ ";
+    out.WriteQuoted(m_outcomes[outc]->m_label);
+    out << ' ';
+    for (int pl = 1; pl <= m_players.Length(); pl++)  {
+      out << (const std::string &) m_outcomes[outc]->m_payoffs[pl];
+      out << ((pl < m_players.Length()) ? ", " : " }\n");
+    }
+    out.Check();
   }
+  out << "}\n";
   
-  p_file << "}\n";
+  long size = 1L;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    size *= m_players[pl]->m_strategies.Length();
+  }
+  for (long cont = 1; cont <= size; cont++)  {
+    GameOutcomeRep *outcome = GetResult(cont);
+    out << ((outcome) ? outcome->m_number : 0) << ' ';
+    out.Check();
+  }
+  out << '\n';
+}
+
+//------------------------------------------------------------------------
+//                   GameTableRep: Binary data files
+//------------------------------------------------------------------------
+
+namespace {
+
+const char BINARY_MAGIC[8] = { '\177', 'N', 'F', 'G', 'B', '\r', '\n', '\032' };
+const unsigned long BINARY_VERSION = 1;
+
+/// Returns true if doubles are stored least significant byte first
+bool IsLittleEndian(void)
+{
+  const unsigned int one = 1;
+  return (*reinterpret_cast<const unsigned char *>(&one) == 1);
+}
 
-  p_file << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
+//
+// Assembles the contents of a binary file in memory
+//
+class BinaryWriter {
+private:
+  std::string m_data;
 
-  int ncont = 1;
-  for (int i = 1; i <= NumPlayers(); i++) {
-    ncont *= m_players[i]->m_strategies.Length();
+public:
+  const std::string &GetData(void) const { return m_data; }
+
+  void WriteInt8(int p_value)  { m_data += (char) p_value; }
+  void WriteInt32(long p_value)
+  { 
+    unsigned long value = (unsigned long) p_value;
+    for (int i = 0; i < 4; i++, value >>= 8) {
+      m_data += (char) (value & 0xFF);
+    }
   }
+  void WriteDouble(double p_value)
+  {
+    char bytes[sizeof(double)];
+    memcpy(bytes, &p_value, sizeof(double));
+    bool little = IsLittleEndian();
+    for (unsigned int i = 0; i < sizeof(double); i++) {
+      m_data += bytes[(little) ? i : sizeof(double) - 1 - i];
+    }
+  }
+  void WriteString(const std::string &p_value)
+  { WriteInt32(p_value.length());  m_data += p_value; }
+};
 
-  p_file << "{\n";
-  for (int outc = 1; outc <= m_outcomes.Length(); outc++)   {
-    p_file << "{ \"" << EscapeQuotes(m_outcomes[outc]->m_label) << "\" ";
-    for (int pl = 1; pl <= m_players.Length(); pl++)  {
-      p_file << (const std::string &) m_outcomes[outc]->m_payoffs[pl];
-      
-      if (pl < m_players.Length()) {
-	p_file << ", ";
+//
+// Decodes the contents of a binary file held in memory.  Reading past
+// the end of the data is a format error.
+//
+class BinaryReader {
+private:
+  const std::string &m_data;
+  size_t m_position;
+
+public:
+  BinaryReader(const std::string &p_data) : m_data(p_data), m_position(0) { }
+
+  size_t GetPosition(void) const { return m_position; }
+  bool AtEnd(void) const { return m_position == m_data.length(); }
+  size_t Remaining(void) const { return m_data.length() - m_position; }
+  void Skip(size_t p_bytes)
+  { 
+    if (Remaining() < p_bytes)  throw InvalidFileException();
+    m_position += p_bytes;
+  }
+
+  /// @name Reading values at a given position
+  //@{
+  int Int8At(size_t p_position) const
+  { return (signed char) m_data[p_position]; }
+  unsigned long UInt32At(size_t p_position) const
+  {
+    unsigned long value = 0;
+    for (int i = 3; i >= 0; i--) {
+      value = (value << 8) | (unsigned char) m_data[p_position + i];
+    }
+    return value;
+  }
+  long Int32At(size_t p_position) const
+  {
+    unsigned long value = UInt32At(p_position);
+    return (value & 0x80000000UL) ? -(long) (0xFFFFFFFFUL - value) - 1 : (long) value;
+  }
+  double DoubleAt(size_t p_position) const
+  {
+    char bytes[sizeof(double)];
+    bool little = IsLittleEndian();
+    for (unsigned int i = 0; i < sizeof(double); i++) {
+      bytes[(little) ? i : sizeof(double) - 1 - i] = m_data[p_position + i];
+    }
+    double value;
+    memcpy(&value, bytes, sizeof(double));
+    return value;
+  }
+  //@}
+
+  /// @name Reading values in sequence
+  //@{
+  int ReadInt8(void)  { Skip(1);  return Int8At(m_position - 1); }
+  unsigned long ReadUInt32(void)  { Skip(4);  return UInt32At(m_position - 4); }
+  std::string ReadString(void)
+  {
+    size_t length = ReadUInt32();
+    Skip(length);
+    return m_data.substr(m_position - length, length);
+  }
+  //@}
+};
+
+}  // end anonymous namespace
+
+void GameTableRep::WriteBinaryFile(std::ostream &p_file) const
+{
+  BinaryWriter out;
+  for (int i = 0; i < 8; out.WriteInt8(BINARY_MAGIC[i++]));
+  out.WriteInt32(BINARY_VERSION);
+
+  int numPlayers = m_players.Length(), numOutcomes = m_outcomes.Length();
+  out.WriteInt32(numPlayers);
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    out.WriteInt32(m_players[pl]->m_strategies.Length());
+  }
+  out.WriteInt32(numOutcomes);
+
+  // Payoffs which have no compact representation are written as text
+  int numPayoffs = numOutcomes * numPlayers;
+  Array<int> nums(numPayoffs), dens(numPayoffs), decimals(numPayoffs);
+  std::vector<std::string> texts;
+  for (int outc = 1, i = 1; outc <= numOutcomes; outc++) {
+    for (int pl = 1; pl <= numPlayers; pl++, i++) {
+      const Number &payoff = m_outcomes[outc]->m_payoffs[pl];
+      if (!payoff.GetCompact(nums[i], dens[i], decimals[i]) ||
+	  decimals[i] > 127) {
+	texts.push_back(payoff);
+	nums[i] = texts.size();
+	dens[i] = 0;
+	decimals[i] = -1;
+      }
+    }
+  }
+  out.WriteInt32(texts.size());
+
+  out.WriteString(GetTitle());
+  out.WriteString(GetComment());
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    out.WriteString(m_players[pl]->m_label);
+  }
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); st++) {
+      out.WriteString(m_players[pl]->m_strategies[st]->m_label);
+    }
+  }
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    out.WriteString(m_outcomes[outc]->m_label);
+  }
+  for (size_t i = 0; i < texts.size(); out.WriteString(texts[i++]));
+
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      out.WriteDouble(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+  for (int i = 1; i <= numPayoffs; out.WriteInt32(nums[i++]));
+  for (int i = 1; i <= numPayoffs; out.WriteInt32(dens[i++]));
+  for (int i = 1; i <= numPayoffs; out.WriteInt8(decimals[i++]));
+
+  long size = 1L;
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    size *= m_players[pl]->m_strategies.Length();
+  }
+  for (long cont = 1; cont <= size; cont++) {
+    GameOutcomeRep *outcome = GetResult(cont);
+    out.WriteInt32((outcome) ? outcome->m_number : 0);
+  }
+
+  p_file.write(out.GetData().data(), out.GetData().length());
+}
+
+Game GameTableRep::ReadBinaryFile(std::istream &p_file)
+{
+  std::string data;
+  char buffer[65536];
+  while (p_file.read(buffer, sizeof(buffer)) || p_file.gcount() > 0) {
+    data.append(buffer, p_file.gcount());
+  }
+  BinaryReader in(data);
+
+  for (int i = 0; i < 8; i++) {
+    if (in.ReadInt8() != BINARY_MAGIC[i]) {
+      throw InvalidFileException("Not a binary game file");
+    }
+  }
+  if (in.ReadUInt32() != BINARY_VERSION) {
+    throw InvalidFileException("Unsupported version of binary game file");
+  }
+
+  // Every contingency takes up four bytes of the file, which bounds the
+  // dimensions before anything is allocated
+  Array<int> dim(in.ReadUInt32());
+  double numContingencies = 1.0;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    unsigned long numStrategies = in.ReadUInt32();
+    numContingencies *= numStrategies;
+    if (numStrategies == 0 || numContingencies * 4.0 > in.Remaining()) {
+      throw InvalidFileException();
+    }
+    dim[pl] = numStrategies;
+  }
+  unsigned long numOutcomes = in.ReadUInt32(), numTexts = in.ReadUInt32();
+  int numPlayers = dim.Length();
+  size_t numPayoffs = numOutcomes * numPlayers;
+  if ((double) numOutcomes * numPlayers * 17.0 + numTexts * 4.0 >
+      in.Remaining()) {
+    throw InvalidFileException();
+  }
+
+  GameTableRep *table = new GameTableRep(dim, true);
+  // Assigning this to the container assures that, if something goes
+  // wrong, the class will automatically be cleaned up
+  Game game = table;
+
+  table->m_title = in.ReadString();
+  table->m_comment = in.ReadString();
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    table->m_players[pl]->m_label = in.ReadString();
+  }
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    for (int st = 1; st <= dim[pl]; st++) {
+      table->m_players[pl]->m_strategies[st]->m_label = in.ReadString();
+    }
+  }
+  table->m_outcomes = Array<GameOutcomeRep *>(numOutcomes);
+  for (unsigned long outc = 1; outc <= numOutcomes; outc++) {
+    table->m_outcomes[outc] = new GameOutcomeRep(table, outc);
+    table->m_outcomes[outc]->m_label = in.ReadString();
+  }
+  Array<std::string> texts(numTexts);
+  for (unsigned long i = 1; i <= numTexts; texts[i++] = in.ReadString());
+
+  size_t values = in.GetPosition(), nums = values + 8 * numPayoffs;
+  size_t dens = nums + 4 * numPayoffs, decimals = dens + 4 * numPayoffs;
+  in.Skip(17 * numPayoffs);
+  for (unsigned long outc = 1, i = 0; outc <= numOutcomes; outc++) {
+    for (int pl = 1; pl <= numPlayers; pl++, i++) {
+      Number &payoff = table->m_outcomes[outc]->m_payoffs[pl];
+      long num = in.Int32At(nums + 4 * i), den = in.Int32At(dens + 4 * i);
+      if (den > 0) {
+	payoff.SetCompact(in.DoubleAt(values + 8 * i), num, den, 
+			  in.Int8At(decimals + i));
+      }
+      else if (den == 0 && num >= 1 && (unsigned long) num <= numTexts) {
+	payoff = texts[num];
       }
       else {
-	p_file << " }\n";
+	throw InvalidFileException();
       }
     }
   }
-  p_file << "}\n";
-  
-  for (int cont = 1; cont <= ncont; cont++)  {
-    if (m_results[cont] != 0) {
-      p_file << m_results[cont]->m_number << ' ';
-    }
-    else {
-      p_file << "0 ";
+
+  // Games in which few contingencies have outcomes are kept in sparse
+  // storage, which takes several times the memory per contingency
+  size_t results = in.GetPosition();
+  long size = (long) numContingencies, numResults = 0L;
+  in.Skip(4 * size);
+  for (long cont = 1; cont <= size; cont++) {
+    unsigned long outc = in.UInt32At(results + 4 * (cont - 1));
+    if (outc > numOutcomes) {
+      throw InvalidFileException();
     }
+    if (outc)  numResults++;
+  }
+  table->SetSparse(numResults * 8 < size);
+  for (long cont = 1; cont <= size; cont++) {
+    unsigned long outc = in.UInt32At(results + 4 * (cont - 1));
+    if (outc)  table->SetResult(cont, table->m_outcomes[outc]);
+  }
+  if (!in.AtEnd()) {
+    throw InvalidFileException();
   }
 
-  p_file << '\n';
+  return game;
 }
 
 //------------------------------------------------------------------------
@@ -283,6 +762,7 @@ void GameTableRep::WriteNfgFile(std::ostream &p_file) const
 
 GamePlayer GameTableRep::NewPlayer(void)
 {
+  CheckMutable();
   GamePlayerRep *player = 0;
   player = new GamePlayerRep(this, m_players.Length() + 1, 1);
   m_players.Append(player);
@@ -290,6 +770,7 @@ GamePlayer GameTableRep::NewPlayer(void)
     m_outcomes[outc]->m_payoffs.Append(Number());
   }
   ClearComputedValues();
+  ClearPayoffTables();
   return player;
 }
 
@@ -299,16 +780,27 @@ GamePlayer GameTableRep::NewPlayer(void)
 
 void GameTableRep::DeleteOutcome(const GameOutcome &p_outcome)
 {
+  CheckMutable();
   for (int i = 1; i <= m_results.Length(); i++) {
     if (m_results[i] == p_outcome) {
       m_results[i] = 0;
     }
   }
+  for (std::map<long, GameOutcomeRep *>::iterator result = 
+	 m_sparseResults.begin(); result != m_sparseResults.end(); ) {
+    if (result->second == p_outcome) {
+      m_sparseResults.erase(result++);
+    }
+    else {
+      ++result;
+    }
+  }
   m_outcomes.Remove(m_outcomes.Find(p_outcome))->Invalidate();
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
     m_outcomes[outc]->m_number = outc;
   }
   ClearComputedValues();
+  ClearPayoffTables();
 }
 
 //------------------------------------------------------------------------
@@ -350,6 +842,45 @@ void GameTableRep::RebuildTable(void)
     size *= m_players[pl]->NumStrategies();
   }
 
+  if (m_sparse) {
+    // The old position of each strategy along its player's axis is
+    // recovered from its offset, and that of each contingency from
+    // its index
+    Array<long> oldStrides(m_players.Length());
+    Array<Array<int> > numbers(m_players.Length());
+    long oldStride = 1L;
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      const Array<GameStrategyRep *> &strategies = m_players[pl]->m_strategies;
+      int count = 0;
+      for (int st = 1; st <= strategies.Length(); st++) {
+	if (strategies[st]->m_offset >= 0)  count++;
+      }
+      numbers[pl] = Array<int>(count);
+      for (int st = 1; st <= strategies.Length(); st++) {
+	if (strategies[st]->m_offset >= 0) {
+	  numbers[pl][strategies[st]->m_offset / oldStride + 1] = st;
+	}
+      }
+      oldStrides[pl] = oldStride;
+      oldStride *= count;
+    }
+
+    std::map<long, GameOutcomeRep *> newResults;
+    for (std::map<long, GameOutcomeRep *>::const_iterator result =
+	   m_sparseResults.begin(); result != m_sparseResults.end(); ++result) {
+      long newindex = 1L;
+      for (int pl = 1; pl <= m_players.Length(); pl++) {
+	int position = ((result->first - 1) / oldStrides[pl]) % numbers[pl].Length() + 1;
+	newindex += (numbers[pl][position] - 1) * offsets[pl];
+      }
+      newResults[newindex] = result->second;
+    }
+    m_sparseResults.swap(newResults);
+    ClearPayoffTables();
+    IndexStrategies();
+    return;
+  }
+
   Array<GameOutcomeRep *> newResults(size);
   for (int i = 1; i <= newResults.Length(); newResults[i++] = 0);
 
@@ -373,6 +904,7 @@ void GameTableRep::RebuildTable(void)
   }
 
   m_results = newResults;
+  ClearPayoffTables();
 
   IndexStrategies();
 }
@@ -23,6 +23,8 @@
 #ifndef GAMETABLE_H
 #define GAMETABLE_H
 
+#include <map>
+
 #include "gameexpl.h"
 
 namespace Gambit {
@@ -32,7 +34,44 @@ class GameTableRep : public GameExplicitRep {
   friend class TablePureStrategyProfileRep;
   template <class T> friend class TableMixedStrategyProfileRep;
 private:
+  /// @name Outcomes of the contingencies
+  //@{
+  /// If true, only the contingencies with outcomes are stored, in
+  /// m_sparseResults; otherwise, all are stored, in m_results
+  bool m_sparse;
   Array<GameOutcomeRep *> m_results;
+  std::map<long, GameOutcomeRep *> m_sparseResults;
+
+  /// Returns the outcome of the contingency with the index (null if none)
+  GameOutcomeRep *GetResult(long p_index) const
+  {
+    if (!m_sparse)  return m_results[p_index];
+    std::map<long, GameOutcomeRep *>::const_iterator result = 
+      m_sparseResults.find(p_index);
+    return (result != m_sparseResults.end()) ? result->second : 0;
+  }
+  /// Sets the outcome of the contingency with the index (null for none)
+  void SetResult(long p_index, GameOutcomeRep *p_outcome);
+  //@}
+
+  /// @name Compiled payoff tables
+  //@{
+  /// Per-player payoffs, indexed by contingency in the same layout as
+  /// m_results; built on demand and discarded whenever the game changes
+  mutable Array<Array<double> > m_doublePayoffs;
+  mutable Array<Array<Rational> > m_rationalPayoffs;
+  mutable bool m_hasDoublePayoffs, m_hasRationalPayoffs;
+  /// The offsets (index - 1) of the contingencies with outcomes, in
+  /// increasing order, and the per-player payoffs in each of them
+  mutable Array<long> m_sparseOffsets;
+  mutable Array<Array<double> > m_sparseDoublePayoffs;
+  mutable Array<Array<Rational> > m_sparseRationalPayoffs;
+  mutable bool m_hasSparseOffsets;
+  mutable bool m_hasSparseDoublePayoffs, m_hasSparseRationalPayoffs;
+
+  template <class T> void BuildPayoffTables(Array<Array<T> > &) const;
+  template <class T> void BuildSparsePayoffTables(Array<Array<T> > &) const;
+  //@}
 
   /// @name Private auxiliary functions
   //@{
@@ -40,15 +79,44 @@ private:
   void RebuildTable(void);
   //@}
 
+protected:
+  /// @name Managing the representation
+  //@{
+  /// Discard the compiled payoff tables
+  virtual void ClearPayoffTables(void) const;
+  //@}
+
 public:
   /// @name Lifecycle
   //@{
   /// Construct a new table game with the given dimension
-  /// If p_sparseOutcomes = true, outcomes for all contingencies are left null
+  /// If p_sparseOutcomes = true, outcomes for all contingencies are left
+  /// null, and only the contingencies later given outcomes are stored
   GameTableRep(const Array<int> &p_dim, bool p_sparseOutcomes = false);
   virtual Game Copy(void) const;
   //@}
 
+  /// @name Storage of the outcomes of contingencies
+  //@{
+  /// \brief Returns true if only contingencies with outcomes are stored
+  ///
+  /// In sparse storage, memory is used only for the contingencies which
+  /// have an outcome, and mixed strategy profiles compute payoffs by
+  /// visiting only those.  Looking up the outcome of a contingency
+  /// then takes logarithmic, rather than constant, time.
+  bool IsSparse(void) const { return m_sparse; }
+  /// Changes the storage of the outcomes of contingencies
+  void SetSparse(bool p_sparse);
+  /// Returns the number of contingencies which have an outcome
+  long NumResults(void) const;
+  //@}
+
+  /// @name Sharing the game between threads
+  //@{
+  /// Build the payoff tables and mark the game as read-only
+  virtual void Freeze(void);
+  //@}
+
   /// @name General data access
   //@{
   virtual bool IsTree(void) const { return false; }
@@ -105,9 +173,57 @@ public:
   virtual void DeleteOutcome(const GameOutcome &);
   //@}
 
-  /// @name Writing data files
+  /// @name Compiled payoff tables
+  //@{
+  /// \brief Returns the payoffs to player pl over all contingencies
+  ///
+  /// Returns a read-only, contiguous table of the payoffs to player pl,
+  /// indexed by contingency as computed from the strategy offsets
+  /// (contingency index = 1 + sum of offsets).  Contingencies with no
+  /// outcome have a payoff of zero.  The table is built the first time
+  /// it is requested, and is invalidated by any change to the game.
+  /// The table has an entry for every contingency, even if the game
+  /// uses sparse storage.
+  template <class T> const Array<T> &GetPayoffTable(int pl) const;
+  /// \brief Returns the payoffs to player pl in the contingencies with
+  /// outcomes
+  ///
+  /// The entries correspond to those of GetSparseOffsets(), and are
+  /// built and invalidated as for GetPayoffTable().
+  template <class T> const Array<T> &GetSparsePayoffTable(int pl) const;
+  /// Returns the offsets (index - 1) of the contingencies with outcomes,
+  /// in increasing order
+  const Array<long> &GetSparseOffsets(void) const;
+  //@}
+
+  /// @name Reading and writing data files
   //@{
   virtual void WriteNfgFile(std::ostream &) const;
+  /// \brief Write the game in binary format to the specified stream
+  ///
+  /// The binary format holds the same data as an .nfg file, laid out
+  /// so that it can be loaded without parsing text.  All integers are
+  /// little-endian.  The file consists of, in order:
+  /// - the eight bytes 0x7F 'N' 'F' 'G' 'B' '\r' '\n' 0x1A, followed by
+  ///   the version of the format (currently 1) as a 32-bit integer
+  /// - the number of players, the number of strategies of each player,
+  ///   the number of outcomes, and the number of exact payoffs
+  ///   stored as text, each as a 32-bit integer
+  /// - the title, the comment, the labels of the players, of the
+  ///   strategies (player by player) and of the outcomes, and the text of
+  ///   the exact payoffs; each as a 32-bit length followed by the bytes
+  /// - four arrays, each with one entry for each player in each outcome
+  ///   (outcome by outcome): the payoffs as IEEE doubles; the numerators
+  ///   and the denominators of the exact payoffs in lowest terms, as
+  ///   32-bit integers; and their number of decimal places (-1 if written
+  ///   as an integer or fraction), as bytes.  A denominator of zero
+  ///   indicates the payoff is given by the text whose number (from 1)
+  ///   is the numerator.
+  /// - the number of the outcome (0 for none) of each contingency, with
+  ///   the first player's strategy changing fastest, as 32-bit integers
+  virtual void WriteBinaryFile(std::ostream &) const;
+  /// Reads a game written by WriteBinaryFile()
+  static Game ReadBinaryFile(std::istream &);
   //@}
 
   virtual PureStrategyProfile NewPureStrategyProfile(void) const;
@@ -118,6 +234,11 @@ public:
 
 };
 
+template<> const Array<double> &GameTableRep::GetPayoffTable(int pl) const;
+template<> const Array<Rational> &GameTableRep::GetPayoffTable(int pl) const;
+template<> const Array<double> &GameTableRep::GetSparsePayoffTable(int pl) const;
+template<> const Array<Rational> &GameTableRep::GetSparsePayoffTable(int pl) const;
+
 }
 
 
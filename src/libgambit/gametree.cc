@@ -20,11 +20,16 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "libgambit.h"
 #include "gametree.h"
+#include "writer.h"
 
 namespace Gambit {
 
@@ -49,6 +54,7 @@ bool GameTreeActionRep::Precedes(const GameNode &n) const
 
 void GameTreeActionRep::DeleteAction(void)
 {
+  CheckMutable();
   if (m_infoset->NumActions() == 1) throw UndefinedException();
 
   int where;
@@ -101,6 +107,7 @@ Game GameTreeInfosetRep::GetGame(void) const { return m_efg; }
 
 void GameTreeInfosetRep::SetPlayer(GamePlayer p_player)
 {
+  CheckMutable();
   if (p_player->GetGame() != m_efg) throw MismatchException();
   if (m_player->IsChance() || p_player->IsChance()) throw UndefinedException();
   if (m_player == p_player) return;
@@ -129,6 +136,7 @@ bool GameTreeInfosetRep::Precedes(GameNode p_node) const
 
 GameAction GameTreeInfosetRep::InsertAction(GameAction p_action /* =0 */)
 {
+  CheckMutable();
   if (p_action && p_action->GetInfoset() != this) throw MismatchException();
   
   int where = m_actions.Length() + 1;
@@ -170,6 +178,7 @@ void GameTreeInfosetRep::RemoveAction(int which)
 
 void GameTreeInfosetRep::SetActionProb(int act, const std::string &p_value)
 {
+  CheckMutable();
   m_probs[act] = p_value;
   m_efg->ClearComputedValues();
 }
@@ -188,6 +197,7 @@ void GameTreeInfosetRep::RemoveMember(GameTreeNodeRep *p_node)
 
 void GameTreeInfosetRep::Reveal(GamePlayer p_player)
 {
+  CheckMutable();
   for (int act = 1; act <= m_actions.Length(); act++) {
     GameActionRep *action = m_actions[act];
     for (int iset = 1; iset <= p_player->m_infosets.Length(); iset++) {
@@ -285,6 +295,7 @@ void GameTreeNodeRep::DeleteOutcome(GameOutcomeRep *outc)
 
 void GameTreeNodeRep::SetOutcome(const GameOutcome &p_outcome)
 {
+  CheckMutable();
   if (p_outcome != outcome) {
     outcome = p_outcome;
     m_efg->ClearComputedValues();
@@ -328,6 +339,7 @@ bool GameTreeNodeRep::IsSubgameRoot(void) const
 
 void GameTreeNodeRep::DeleteParent(void)
 {
+  CheckMutable();
   if (!m_parent) return;
   GameTreeNodeRep *oldParent = m_parent;
 
@@ -348,6 +360,7 @@ void GameTreeNodeRep::DeleteParent(void)
 
 void GameTreeNodeRep::DeleteTree(void)
 {
+  CheckMutable();
   for (int i = 1; i <= children.Length(); i++) {
     children[i]->DeleteTree();
     children[i]->Invalidate();
@@ -386,6 +399,7 @@ void GameTreeNodeRep::CopySubtree(GameTreeNodeRep *src, GameTreeNodeRep *stop)
 
 void GameTreeNodeRep::CopyTree(GameNode p_src)
 {
+  CheckMutable();
   if (p_src->GetGame() != m_efg) throw MismatchException();
   if (p_src == this || children.Length() > 0) return;
 
@@ -404,6 +418,7 @@ void GameTreeNodeRep::CopyTree(GameNode p_src)
 
 void GameTreeNodeRep::MoveTree(GameNode p_src)
 {
+  CheckMutable();
   if (p_src->GetGame() != m_efg) throw MismatchException();
   if (p_src == this || children.Length() > 0 || IsSuccessorOf(p_src)) {
     return;
@@ -442,6 +457,7 @@ Game GameTreeNodeRep::CopySubgame(void) const
 
 void GameTreeNodeRep::SetInfoset(GameInfoset p_infoset)
 {
+  CheckMutable();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
   if (!infoset || infoset == p_infoset) return;
   if (p_infoset->NumActions() != children.Length()) 
@@ -457,6 +473,7 @@ void GameTreeNodeRep::SetInfoset(GameInfoset p_infoset)
 
 GameInfoset GameTreeNodeRep::LeaveInfoset(void)
 {
+  CheckMutable();
   if (!infoset) return 0;
 
   GameTreeInfosetRep *oldInfoset = infoset;
@@ -478,6 +495,7 @@ GameInfoset GameTreeNodeRep::LeaveInfoset(void)
 
 GameInfoset GameTreeNodeRep::AppendMove(GamePlayer p_player, int p_actions)
 {
+  CheckMutable();
   if (p_actions <= 0 || children.Length() > 0) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
@@ -488,6 +506,7 @@ GameInfoset GameTreeNodeRep::AppendMove(GamePlayer p_player, int p_actions)
 
 GameInfoset GameTreeNodeRep::AppendMove(GameInfoset p_infoset)
 {
+  CheckMutable();
   if (children.Length() > 0) throw UndefinedException();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
   
@@ -504,6 +523,7 @@ GameInfoset GameTreeNodeRep::AppendMove(GameInfoset p_infoset)
   
 GameInfoset GameTreeNodeRep::InsertMove(GamePlayer p_player, int p_actions)
 {
+  CheckMutable();
   if (p_actions <= 0) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
@@ -514,6 +534,7 @@ GameInfoset GameTreeNodeRep::InsertMove(GamePlayer p_player, int p_actions)
 
 GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 {
+  CheckMutable();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
 
   GameTreeNodeRep *newNode = new GameTreeNodeRep(m_efg, m_parent);
@@ -549,6 +570,8 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 //------------------------------------------------------------------------
 
 GameTreeRep::GameTreeRep(void)
+  : m_hasDoubleTree(false), m_hasRationalTree(false), m_compiledVersion(1),
+    m_strategicClock(0), m_strategicCacheSize(1L << 18)
 {
   m_computedValues = false;
   m_chance = new GamePlayerRep(this, 0);
@@ -740,6 +763,7 @@ void GameTreeRep::ClearComputedValues(void) const
   }
 
   m_computedValues = false;
+  ClearPayoffTables();
 }
 
 void GameTreeRep::BuildComputedValues(void)
@@ -761,119 +785,270 @@ void GameTreeRep::BuildComputedValues(void)
 }
 
 //------------------------------------------------------------------------
-//                  GameTreeRep: Writing data files
+//               GameTreeRep: Sharing the game between threads
 //------------------------------------------------------------------------
 
 namespace {
 
-std::string EscapeQuotes(const std::string &s)
+void FreezeSubtree(GameNode p_node)
 {
-  std::string ret;
-  
-  for (unsigned int i = 0; i < s.length(); i++)  {
-    if (s[i] == '"')   ret += '\\';
-    ret += s[i];
+  for (int i = 1; i <= p_node->NumChildren(); 
+       FreezeSubtree(p_node->GetChild(i++)));
+  p_node->MarkFrozen();
+}
+
+}  // end anonymous namespace
+
+void GameTreeRep::Freeze(void)
+{
+  if (m_frozen)  return;
+
+  BuildComputedValues();
+  GetCompiledTree<double>();
+  GetCompiledTree<Rational>();
+
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      for (int act = 1; act <= infoset->m_probs.Length(); 
+	   infoset->m_probs[act++].Materialize());
+      for (int act = 1; act <= infoset->m_actions.Length(); 
+	   infoset->m_actions[act++]->MarkFrozen());
+      infoset->MarkFrozen();
+    }
+  }
+  m_chance->MarkFrozen();
+  FreezeSubtree(m_root);
+
+  GameExplicitRep::Freeze();
+}
+
+//------------------------------------------------------------------------
+//                     GameTreeRep: Compiled trees
+//------------------------------------------------------------------------
+
+template <class T>
+void GameTreeRep::CompileNode(CompiledTree<T> &p_tree, GameTreeNodeRep *p_node,
+			      const Array<int> &p_offsets, int &p_nextChild) const
+{
+  int n = p_node->GetNumber();
+  p_tree.m_subtreeEnd[n] = n;
+  if (!p_node->infoset) {
+    return;
+  }
+
+  GameTreeInfosetRep *infoset = p_node->infoset;
+  int pl = infoset->m_player->m_number;
+  p_tree.m_infoset[n] = ((pl) ? p_offsets[pl] : p_offsets[p_offsets.Length()]) + infoset->m_number;
+  p_tree.m_firstChild[n] = p_nextChild;
+  p_tree.m_numChildren[n] = p_node->children.Length();
+  p_nextChild += p_node->children.Length();
+
+  for (int i = 1; i <= p_node->children.Length(); i++) {
+    GameTreeNodeRep *child = p_node->children[i];
+    int c = child->GetNumber();
+    p_tree.m_children[p_tree.m_firstChild[n] + i - 1] = c;
+    p_tree.m_parent[c] = n;
+    p_tree.m_priorAction[c] = i;
+    p_tree.m_outcome[c] = (child->outcome) ? child->outcome->m_number : 0;
+    if (pl == 0) {
+      p_tree.m_moveProbs[c] = infoset->GetActionProb(i, (T) 0);
+    }
+    CompileNode(p_tree, child, p_offsets, p_nextChild);
+    p_tree.m_subtreeEnd[n] = p_tree.m_subtreeEnd[c];
+  }
+}
+
+template <class T> 
+void GameTreeRep::BuildCompiledTree(CompiledTree<T> &p_tree) const
+{
+  int numNodes = NumNodes();
+  p_tree.m_numPlayers = m_players.Length();
+  p_tree.m_parent = Array<int>(numNodes);
+  p_tree.m_subtreeEnd = Array<int>(numNodes);
+  p_tree.m_infoset = Array<int>(numNodes);
+  p_tree.m_priorAction = Array<int>(numNodes);
+  p_tree.m_firstChild = Array<int>(numNodes);
+  p_tree.m_numChildren = Array<int>(numNodes);
+  p_tree.m_children = Array<int>(numNodes - 1);
+  p_tree.m_outcome = Array<int>(numNodes);
+  p_tree.m_moveProbs = Array<T>(numNodes);
+  for (int n = 1; n <= numNodes; n++) {
+    p_tree.m_infoset[n] = p_tree.m_firstChild[n] = p_tree.m_numChildren[n] = 0;
+    p_tree.m_moveProbs[n] = (T) 1;
+  }
+
+  // Information sets of each player are numbered after all those
+  // of the players before; chance comes last
+  Array<int> offsets(m_players.Length() + 1);
+  p_tree.m_infosetPlayer = Array<int>();
+  p_tree.m_infosetNumber = Array<int>();
+  for (int pl = 1; pl <= m_players.Length() + 1; pl++) {
+    offsets[pl] = p_tree.m_infosetPlayer.Length();
+    GamePlayerRep *player = (pl <= m_players.Length()) ? m_players[pl] : m_chance;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      p_tree.m_infosetPlayer.Append(player->m_number);
+      p_tree.m_infosetNumber.Append(iset);
+    }
+  }
+  p_tree.m_numPersonalInfosets = offsets[offsets.Length()];
+
+  p_tree.m_parent[m_root->GetNumber()] = 0;
+  p_tree.m_priorAction[m_root->GetNumber()] = 0;
+  p_tree.m_outcome[m_root->GetNumber()] = (m_root->outcome) ? m_root->outcome->m_number : 0;
+  int nextChild = 1;
+  CompileNode(p_tree, m_root, offsets, nextChild);
+  p_tree.m_playerOffset = offsets;
+
+  // Members of each information set are listed together, in node order
+  int numInfosets = p_tree.m_infosetPlayer.Length();
+  p_tree.m_firstMember = Array<int>(numInfosets + 1);
+  for (int k = 1; k <= numInfosets + 1; p_tree.m_firstMember[k++] = 0);
+  for (int n = 1; n <= numNodes; n++) {
+    if (p_tree.m_infoset[n]) {
+      p_tree.m_firstMember[p_tree.m_infoset[n]]++;
+    }
+  }
+  for (int k = 1, first = 1; k <= numInfosets + 1; k++) {
+    int count = p_tree.m_firstMember[k];
+    p_tree.m_firstMember[k] = first;
+    first += count;
+  }
+  p_tree.m_members = Array<int>(p_tree.m_firstMember[numInfosets + 1] - 1);
+  Array<int> filled(numInfosets);
+  for (int k = 1; k <= numInfosets; filled[k++] = 0);
+  for (int n = 1; n <= numNodes; n++) {
+    int k = p_tree.m_infoset[n];
+    if (k) {
+      p_tree.m_members[p_tree.m_firstMember[k] + filled[k]++] = n;
+    }
+  }
+
+  p_tree.m_payoffs = Array<T>(m_outcomes.Length() * m_players.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      p_tree.m_payoffs[(outc - 1) * m_players.Length() + pl] = 
+	m_outcomes[outc]->GetPayoff<T>(pl);
+    }
+  }
+}
+
+template<> const CompiledTree<double> &GameTreeRep::GetCompiledTree(void) const
+{
+  if (!m_hasDoubleTree) {
+    BuildCompiledTree(m_doubleTree);
+    m_hasDoubleTree = true;
   }
+  return m_doubleTree;
+}
 
-  return ret;
+template<> const CompiledTree<Rational> &GameTreeRep::GetCompiledTree(void) const
+{
+  if (!m_hasRationalTree) {
+    BuildCompiledTree(m_rationalTree);
+    m_hasRationalTree = true;
+  }
+  return m_rationalTree;
 }
 
-void PrintActions(std::ostream &p_stream, GameTreeInfosetRep *p_infoset)
+void GameTreeRep::ClearPayoffTables(void) const
+{
+  m_doubleTree = CompiledTree<double>();
+  m_rationalTree = CompiledTree<Rational>();
+  m_hasDoubleTree = m_hasRationalTree = false;
+  m_compiledVersion++;
+  m_strategicBlocks.clear();
+}
+
+//------------------------------------------------------------------------
+//                  GameTreeRep: Writing data files
+//------------------------------------------------------------------------
+
+namespace {
+
+void WriteActions(GameFileWriter &p_out, GameTreeInfosetRep *p_infoset)
 { 
-  p_stream << "{ ";
+  p_out << "{ ";
   for (int act = 1; act <= p_infoset->NumActions(); act++) {
-    p_stream << '"' << EscapeQuotes(p_infoset->GetAction(act)->GetLabel()) << "\" ";
+    p_out.WriteQuoted(p_infoset->GetAction(act)->GetLabel());
+    p_out << ' ';
     if (p_infoset->IsChanceInfoset()) {
-      p_stream << p_infoset->GetActionProb(act, "") << ' ';
+      p_out << p_infoset->GetActionProb(act, "") << ' ';
     }
   }
-  p_stream << "}";
+  p_out << "}";
 }
 
-void WriteEfgFile(std::ostream &f, GameTreeNodeRep *n)
+void WriteOutcome(GameFileWriter &p_out, const GameOutcome &p_outcome)
 {
-  if (n->NumChildren() == 0)   {
-    f << "t \"" << EscapeQuotes(n->GetLabel()) << "\" ";
-    if (n->GetOutcome())  {
-      f << n->GetOutcome()->GetNumber() << " \"" <<
-	EscapeQuotes(n->GetOutcome()->GetLabel()) << "\" ";
-      f << "{ ";
-      for (int pl = 1; pl <= n->GetGame()->NumPlayers(); pl++)  {
-	f << n->GetOutcome()->GetPayoff<std::string>(pl);
-
-	if (pl < n->GetGame()->NumPlayers()) {
-	  f << ", ";
-	}
-	else {
-	  f << " }\n";
-	}
-      }
-    }
-    else {
-      f << "0\n";
-    }
+  if (!p_outcome) {
+    p_out << "0\n";
     return;
   }
+  p_out << p_outcome->GetNumber() << ' ';
+  p_out.WriteQuoted(p_outcome->GetLabel());
+  p_out << " { ";
+  int numPlayers = p_outcome->GetGame()->NumPlayers();
+  for (int pl = 1; pl <= numPlayers; pl++)  {
+    p_out << p_outcome->GetPayoff<std::string>(pl);
+    p_out << ((pl < numPlayers) ? ", " : " }\n");
+  }
+}
 
-  if (n->GetInfoset()->IsChanceInfoset()) {
-    f << "c \"";
+void WriteEfgFile(GameFileWriter &p_out, GameTreeNodeRep *n)
+{
+  if (n->NumChildren() == 0)   {
+    p_out << "t ";
+    p_out.WriteQuoted(n->GetLabel());
+    p_out << ' ';
+    WriteOutcome(p_out, n->GetOutcome());
+    p_out.Check();
+    return;
   }
-  else {
-    f << "p \"";
-  }
-
-  f << EscapeQuotes(n->GetLabel()) << "\" ";
-  if (!n->GetInfoset()->IsChanceInfoset()) {
-    f << n->GetInfoset()->GetPlayer()->GetNumber() << ' ';
-  }
-  f << n->GetInfoset()->GetNumber() << " \"" <<
-    EscapeQuotes(n->GetInfoset()->GetLabel()) << "\" ";
-  PrintActions(f, dynamic_cast<GameTreeInfosetRep *>(n->GetInfoset().operator->()));
-  f << " ";
-  if (n->GetOutcome())  {
-    f << n->GetOutcome()->GetNumber() << " \"" <<
-      EscapeQuotes(n->GetOutcome()->GetLabel()) << "\" ";
-    f << "{ ";
-    for (int pl = 1; pl <= n->GetGame()->NumPlayers(); pl++)  {
-      f << n->GetOutcome()->GetPayoff<std::string>(pl);
-      
-      if (pl < n->GetGame()->NumPlayers())
-	f << ", ";
-      else
-	f << " }\n";
-    }
+
+  GameTreeInfosetRep *infoset = 
+    dynamic_cast<GameTreeInfosetRep *>(n->GetInfoset().operator->());
+  p_out << ((infoset->IsChanceInfoset()) ? "c " : "p ");
+  p_out.WriteQuoted(n->GetLabel());
+  p_out << ' ';
+  if (!infoset->IsChanceInfoset()) {
+    p_out << infoset->GetPlayer()->GetNumber() << ' ';
   }
-  else
-    f << "0\n";
+  p_out << infoset->GetNumber() << ' ';
+  p_out.WriteQuoted(infoset->GetLabel());
+  p_out << ' ';
+  WriteActions(p_out, infoset);
+  p_out << ' ';
+  WriteOutcome(p_out, n->GetOutcome());
+  p_out.Check();
 
   for (int i = 1; i <= n->NumChildren(); 
-       WriteEfgFile(f, dynamic_cast<GameTreeNodeRep *>(n->GetChild(i++).operator->())));
+       WriteEfgFile(p_out, dynamic_cast<GameTreeNodeRep *>(n->GetChild(i++).operator->())));
 }
 
 } // end anonymous namespace
 
 void GameTreeRep::WriteEfgFile(std::ostream &p_file) const
 {
-  p_file << "EFG 2 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
-  for (int i = 1; i <= m_players.Length(); i++)
-    p_file << '"' << EscapeQuotes(m_players[i]->m_label) << "\" ";
-  p_file << "}\n";
-  p_file << "\"" << EscapeQuotes(GetComment()) << "\"\n\n";
-
-  Gambit::WriteEfgFile(p_file, m_root);
+  WriteEfgFile(p_file, m_root);
 }
 
 void GameTreeRep::WriteEfgFile(std::ostream &p_file, const GameNode &p_root) const
 {
-  p_file << "EFG 2 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
-  for (int i = 1; i <= m_players.Length(); i++)
-    p_file << '"' << EscapeQuotes(m_players[i]->m_label) << "\" ";
-  p_file << "}\n";
-  p_file << "\"" << EscapeQuotes(GetComment()) << "\"\n\n";
+  GameFileWriter out(p_file);
+  out << "EFG 2 R ";
+  out.WriteQuoted(GetTitle());
+  out << " { ";
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    out.WriteQuoted(m_players[pl]->m_label);
+    out << ' ';
+  }
+  out << "}\n";
+  out.WriteQuoted(GetComment());
+  out << "\n\n";
 
-  Gambit::WriteEfgFile(p_file, 
+  Gambit::WriteEfgFile(out, 
 		       dynamic_cast<GameTreeNodeRep *>(p_root.operator->()));
 }
 
@@ -882,39 +1057,35 @@ void GameTreeRep::WriteNfgFile(std::ostream &p_file) const
   // FIXME: Building computed values is logically const.
   const_cast<GameTreeRep *>(this)->BuildComputedValues();
 
-  p_file << "NFG 1 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
-
-  for (int i = 1; i <= NumPlayers(); i++)
-    p_file << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
-
-  p_file << "}\n\n{ ";
-  
-  for (int i = 1; i <= NumPlayers(); i++)   {
-    GamePlayerRep *player = GetPlayer(i);
-    p_file << "{ ";
-    for (int j = 1; j <= player->NumStrategies(); j++)
-      p_file << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
-    p_file << "}\n";
+  GameFileWriter out(p_file);
+  out << "NFG 1 R ";
+  out.WriteQuoted(GetTitle());
+  out << " { ";
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    out.WriteQuoted(m_players[pl]->m_label);
+    out << ' ';
   }
+  out << "}\n\n{ ";
   
-  p_file << "}\n";
+  for (int pl = 1; pl <= m_players.Length(); pl++)   {
+    GamePlayerRep *player = m_players[pl];
+    out << "{ ";
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      out.WriteQuoted(player->m_strategies[st]->m_label);
+      out << ' ';
+    }
+    out << "}\n";
+  }
+  out << "}\n";
 
-  p_file << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
+  out.WriteQuoted(m_comment);
+  out << "\n\n";
 
   // For trees, we write the payoff version, since there need not be
   // a one-to-one correspondence between outcomes and entries, when there
   // are chance moves.
-  StrategyIterator iter(Game(const_cast<GameTreeRep *>(this)));
-    
-  for (; !iter.AtEnd(); iter++) {
-    for (int pl = 1; pl <= NumPlayers(); pl++) {
-      p_file << (*iter)->GetPayoff(pl) << " ";
-    }
-    p_file << "\n";
-  }
-
-  p_file << '\n';
+  WriteStrategicPayoffs(out);
+  out << '\n';
 }
 
 //------------------------------------------------------------------------
@@ -971,6 +1142,7 @@ int GameTreeRep::BehavProfileLength(void) const
 
 GamePlayer GameTreeRep::NewPlayer(void)
 {
+  CheckMutable();
   GamePlayerRep *player = 0;
   player = new GamePlayerRep(this, m_players.Length() + 1);
   m_players.Append(player);
@@ -1032,6 +1204,7 @@ GameAction GameTreeRep::GetAction(int p_index) const
 
 void GameTreeRep::DeleteOutcome(const GameOutcome &p_outcome)
 {
+  CheckMutable();
   m_root->DeleteOutcome(p_outcome);
   m_outcomes.Remove(m_outcomes.Find(p_outcome))->Invalidate();
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
@@ -1090,6 +1263,36 @@ MixedStrategyProfile<Rational> GameTreeRep::NewMixedStrategyProfile(const Ration
 //========================================================================
 
 class TreePureStrategyProfileRep : public PureStrategyProfileRep {
+  friend class GameTreeRep;
+protected:
+  /// @name Payoffs of subtrees
+  /// The payoffs to each player of the subtree rooted at each node are
+  /// stored, and recomputed only when stale.  When a player's strategy
+  /// changes, the nodes at information sets where the action changes,
+  /// and the nodes above which depend on them, are marked stale; they
+  /// are recomputed, as far as reached by the profile, when a payoff
+  /// is next requested.  A node is never up to date unless all nodes
+  /// its payoffs depend on are.
+  //@{
+  /// The version of the game's compiled tree the values are computed
+  /// on; zero if there are none
+  mutable unsigned long m_version;
+  /// The action taken at each personal information set of the tree
+  mutable Array<int> m_actions;
+  /// The payoff to player pl at node n is at (n-1)*NumPlayers()+pl
+  mutable Array<Rational> m_values;
+  mutable Array<bool> m_stale;
+
+  const CompiledTree<Rational> &GetTree(void) const
+  { return dynamic_cast<GameTreeRep &>(*m_nfg).GetCompiledTree<Rational>(); }
+  void InitValues(void) const;
+  const Rational *GetNodeValues(const CompiledTree<Rational> &, int n) const;
+  void ChangeActions(int pl, const GameStrategy &p_from,
+		     const GameStrategy &p_to) const;
+  /// Returns the payoff to player pl, computed from the tree
+  Rational GetTreePayoff(int pl) const;
+  //@}
+
 public:
   TreePureStrategyProfileRep(const Game &p_game);
   virtual PureStrategyProfile Copy(void) const;
@@ -1107,6 +1310,7 @@ public:
 //------------------------------------------------------------------------
 
 TreePureStrategyProfileRep::TreePureStrategyProfileRep(const Game &p_nfg)
+  : m_version(0)
 {
   m_nfg = p_nfg;
   m_profile = Array<GameStrategy>(m_nfg->NumPlayers());
@@ -1125,37 +1329,292 @@ PureStrategyProfile GameTreeRep::NewPureStrategyProfile(void) const
   return PureStrategyProfile(new TreePureStrategyProfileRep(const_cast<GameTreeRep *>(this)));
 }
 
+//------------------------------------------------------------------------
+//            TreePureStrategyProfileRep: Payoffs of subtrees
+//------------------------------------------------------------------------
+
+void TreePureStrategyProfileRep::InitValues(void) const
+{
+  const CompiledTree<Rational> &tree = GetTree();
+
+  // Actions at information sets a strategy does not reach are immaterial;
+  // they are taken to be the first, as in PureBehavProfile
+  m_actions = Array<int>(tree.NumPersonalInfosets());
+  for (int pl = 1; pl <= m_nfg->NumPlayers(); pl++) {
+    const Array<int> &behav = m_profile[pl]->m_behav;
+    for (int iset = 1; iset <= behav.Length(); iset++) {
+      m_actions[tree.GetInfosetIndex(pl, iset)] = (behav[iset]) ? behav[iset] : 1;
+    }
+  }
+
+  m_values = Array<Rational>(tree.NumNodes() * tree.NumPlayers());
+  m_stale = Array<bool>(tree.NumNodes());
+  for (int n = 1; n <= m_stale.Length(); m_stale[n++] = true);
+  m_version = dynamic_cast<GameTreeRep &>(*m_nfg).m_compiledVersion;
+}
+
+const Rational *
+TreePureStrategyProfileRep::GetNodeValues(const CompiledTree<Rational> &p_tree,
+					  int n) const
+{
+  int numPlayers = p_tree.NumPlayers();
+  Rational *values = &m_values[(n - 1) * numPlayers + 1];
+  if (!m_stale[n]) {
+    return values;
+  }
+
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    values[pl - 1] = (p_tree.HasOutcome(n)) ? p_tree.GetPayoff(n, pl) : Rational(0);
+  }
+
+  int infoset = p_tree.GetInfoset(n);
+  if (infoset == 0) {
+    // terminal node; nothing further to add
+  }
+  else if (p_tree.GetInfosetPlayer(infoset) == 0) {
+    for (int i = 1; i <= p_tree.NumChildren(n); i++) {
+      int child = p_tree.GetChild(n, i);
+      const Rational *childValues = GetNodeValues(p_tree, child);
+      for (int pl = 1; pl <= numPlayers; pl++) {
+	values[pl - 1] += p_tree.GetMoveProb(child) * childValues[pl - 1];
+      }
+    }
+  }
+  else {
+    const Rational *childValues = 
+      GetNodeValues(p_tree, p_tree.GetChild(n, m_actions[infoset]));
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      values[pl - 1] += childValues[pl - 1];
+    }
+  }
+
+  m_stale[n] = false;
+  return values;
+}
+
+void TreePureStrategyProfileRep::ChangeActions(int pl,
+					       const GameStrategy &p_from,
+					       const GameStrategy &p_to) const
+{
+  const CompiledTree<Rational> &tree = GetTree();
+  const Array<int> &from = p_from->m_behav, &to = p_to->m_behav;
+
+  for (int iset = 1; iset <= to.Length(); iset++) {
+    int action = (to[iset]) ? to[iset] : 1;
+    if (action == ((from[iset]) ? from[iset] : 1))  continue;
+    int k = tree.GetInfosetIndex(pl, iset);
+    m_actions[k] = action;
+
+    // Mark the members stale, and the nodes above as far as they depend
+    // on the node below; nodes depending on a stale node are already stale
+    for (int i = 1; i <= tree.NumMembers(k); i++) {
+      int n = tree.GetMember(k, i);
+      while (n > 0 && !m_stale[n]) {
+	m_stale[n] = true;
+	int parent = tree.GetParent(n);
+	if (parent > 0) {
+	  int infoset = tree.GetInfoset(parent);
+	  if (tree.GetInfosetPlayer(infoset) != 0 &&
+	      tree.GetChild(parent, m_actions[infoset]) != n) {
+	    break;
+	  }
+	}
+	n = parent;
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------
 //       TreePureStrategyProfileRep: Data access and manipulation
 //------------------------------------------------------------------------
 
 void TreePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 {
-  m_profile[s->GetPlayer()->GetNumber()] = s;
+  int pl = s->GetPlayer()->GetNumber();
+  GameStrategy from = m_profile[pl];
+  m_profile[pl] = s;
+  if (m_version == dynamic_cast<GameTreeRep &>(*m_nfg).m_compiledVersion) {
+    ChangeActions(pl, from, s);
+  }
+  else {
+    m_version = 0;
+  }
+}
+
+Rational TreePureStrategyProfileRep::GetTreePayoff(int pl) const
+{
+  if (m_version != dynamic_cast<GameTreeRep &>(*m_nfg).m_compiledVersion) {
+    InitValues();
+  }
+  // The root is the first node
+  return GetNodeValues(GetTree(), 1)[pl - 1];
 }
 
 Rational TreePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  PureBehavProfile behav(m_nfg);
-  for (int i = 1; i <= m_nfg->NumPlayers(); i++) {
-    GamePlayer player = m_nfg->GetPlayer(i);
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      int act = m_profile[i]->m_behav[iset];
-      if (act) {
-	behav.SetAction(player->GetInfoset(iset)->GetAction(act));
-      }
-    }
+  const GameTreeRep &tree = dynamic_cast<GameTreeRep &>(*m_nfg);
+  if (tree.UseStrategicCache()) {
+    return tree.GetStrategicPayoffs(m_profile)[pl - 1];
   }
-  return behav.GetPayoff<Rational>(pl);
+  return GetTreePayoff(pl);
 }
 
 Rational
 TreePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
-  PureStrategyProfile copy = Copy();
-  copy->SetStrategy(p_strategy);
-  return copy->GetPayoff(p_strategy->GetPlayer()->GetNumber());
+  int pl = p_strategy->GetPlayer()->GetNumber();
+  if (p_strategy == m_profile[pl]) {
+    return GetPayoff(pl);
+  }
+  const GameTreeRep &tree = dynamic_cast<GameTreeRep &>(*m_nfg);
+  if (tree.UseStrategicCache()) {
+    Array<GameStrategy> profile(m_profile);
+    profile[pl] = p_strategy;
+    return tree.GetStrategicPayoffs(profile)[pl - 1];
+  }
+  if (m_version != dynamic_cast<GameTreeRep &>(*m_nfg).m_compiledVersion) {
+    InitValues();
+  }
+  ChangeActions(pl, m_profile[pl], p_strategy);
+  Rational value = GetNodeValues(GetTree(), 1)[pl - 1];
+  ChangeActions(pl, p_strategy, m_profile[pl]);
+  return value;
+}
+
+
+//------------------------------------------------------------------------
+//          GameTreeRep: Payoffs of the reduced strategic form
+//------------------------------------------------------------------------
+
+namespace {
+
+/// The number of consecutive contingencies whose payoffs are computed
+/// together
+const long STRATEGIC_BLOCK_SIZE = 1024;
+
+}  // end anonymous namespace
+
+void GameTreeRep::SetStrategicCacheSize(long p_contingencies)
+{
+  m_strategicCacheSize = (p_contingencies > 0) ? p_contingencies : 0;
+  m_strategicBlocks.clear();
 }
 
+//
+// Computes the payoffs of the contingencies numbered p_first through
+// p_first+p_count-1.  As the first player's strategy changes fastest,
+// successive contingencies mostly differ in that strategy alone, and
+// the profile revises its payoffs incrementally.
+//
+void GameTreeRep::FillStrategicBlock(long p_first, long p_count,
+				     Array<Rational> &p_payoffs) const
+{
+  int numPlayers = m_players.Length();
+  TreePureStrategyProfileRep profile(const_cast<GameTreeRep *>(this));
+  Array<int> current(numPlayers);
+  for (int pl = 1; pl <= numPlayers; current[pl++] = 1);
+
+  p_payoffs = Array<Rational>(p_count * numPlayers);
+  for (long k = 0; k < p_count; k++) {
+    long index = p_first + k;
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      int numStrategies = m_players[pl]->m_strategies.Length();
+      int st = index % numStrategies + 1;
+      index /= numStrategies;
+      if (st != current[pl]) {
+	profile.SetStrategy(m_players[pl]->m_strategies[st]);
+	current[pl] = st;
+      }
+    }
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      p_payoffs[k * numPlayers + pl] = profile.GetTreePayoff(pl);
+    }
+  }
+}
+
+//
+// Writes the payoffs of each contingency on a line, in the order of the
+// .nfg format.  The payoffs are computed a block of contingencies at a
+// time, as for the cache, but without storing them there.  If the game
+// is frozen, several blocks are computed and formatted at once on
+// separate threads, and their text is then written out in order.
+//
+void GameTreeRep::WriteStrategicPayoffs(GameFileWriter &p_out) const
+{
+  int numPlayers = m_players.Length();
+  long size = 1L;
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    size *= m_players[pl]->m_strategies.Length();
+  }
+  long numBlocks = (size + STRATEGIC_BLOCK_SIZE - 1) / STRATEGIC_BLOCK_SIZE;
+
+  int numThreads = 1;
+#ifdef _OPENMP
+  if (IsFrozen())  numThreads = omp_get_max_threads();
+#endif
+  // Blocks are done in rounds of a few per thread, which bounds the
+  // amount of text held at once
+  long roundSize = (numThreads > 1) ? 4 * numThreads : 1;
+  Array<GameFileText> text(roundSize);
+
+  for (long round = 0; round < numBlocks; round += roundSize) {
+    long count = std::min(roundSize, numBlocks - round);
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+    for (long b = 0; b < count; b++) {
+      long first = (round + b) * STRATEGIC_BLOCK_SIZE;
+      long length = std::min(STRATEGIC_BLOCK_SIZE, size - first);
+      Array<Rational> payoffs;
+      FillStrategicBlock(first, length, payoffs);
+      text[b + 1].Clear();
+      for (long k = 0; k < length; k++) {
+	for (int pl = 1; pl <= numPlayers; pl++) {
+	  text[b + 1] << payoffs[k * numPlayers + pl] << ' ';
+	}
+	text[b + 1] << '\n';
+      }
+    }
+    for (long b = 1; b <= count; b++) {
+      p_out << text[b].GetText();
+      p_out.Check();
+    }
+  }
+}
+
+const Rational *
+GameTreeRep::GetStrategicPayoffs(const Array<GameStrategy> &p_profile) const
+{
+  int numPlayers = m_players.Length();
+  long index = 0L, size = 1L;
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    index += (p_profile[pl]->GetNumber() - 1) * size;
+    size *= m_players[pl]->m_strategies.Length();
+  }
+
+  long blockSize = std::min(STRATEGIC_BLOCK_SIZE, m_strategicCacheSize);
+  long number = index / blockSize;
+  std::map<long, StrategicBlock>::iterator block = 
+    m_strategicBlocks.find(number);
+  if (block == m_strategicBlocks.end()) {
+    if ((long) m_strategicBlocks.size() >= m_strategicCacheSize / blockSize) {
+      std::map<long, StrategicBlock>::iterator oldest = 
+	m_strategicBlocks.begin();
+      for (std::map<long, StrategicBlock>::iterator iter = oldest;
+	   iter != m_strategicBlocks.end(); ++iter) {
+	if (iter->second.m_lastUse < oldest->second.m_lastUse) {
+	  oldest = iter;
+	}
+      }
+      m_strategicBlocks.erase(oldest);
+    }
+    block = m_strategicBlocks.insert(std::make_pair(number, 
+						    StrategicBlock())).first;
+    FillStrategicBlock(number * blockSize, 
+		       std::min(blockSize, size - number * blockSize),
+		       block->second.m_payoffs);
+  }
+  block->second.m_lastUse = ++m_strategicClock;
+  return &block->second.m_payoffs[(index - number * blockSize) * numPlayers + 1];
+}
 
 }  // end namespace Gambit
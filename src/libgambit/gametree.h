@@ -23,11 +23,13 @@
 #ifndef GAMETREE_H
 #define GAMETREE_H
 
+#include <map>
 #include "gameexpl.h"
 
 namespace Gambit {
 
 class GameTreeRep;
+class GameFileWriter;
 
 class GameTreeActionRep : public GameActionRep {
   friend class GameTreeRep;
@@ -49,7 +51,8 @@ public:
   GameInfoset GetInfoset(void) const;
 
   const std::string &GetLabel(void) const { return m_label; }
-  void SetLabel(const std::string &p_label) { m_label = p_label; }
+  void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
 
   bool Precedes(const GameNode &) const;
 
@@ -62,6 +65,7 @@ class GameTreeInfosetRep : public GameInfosetRep {
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
   template <class T> friend class MixedBehavProfile;
+  template <class T> friend class TreeMixedStrategyProfileRep;
 
 protected:
   GameTreeRep *m_efg;
@@ -93,7 +97,8 @@ public:
 
   virtual bool IsChanceInfoset(void) const;
 
-  virtual void SetLabel(const std::string &p_label) { m_label = p_label; }
+  virtual void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
   virtual const std::string &GetLabel(void) const { return m_label; }
   
   virtual GameAction InsertAction(GameAction p_where = 0);
@@ -133,6 +138,7 @@ class GameTreeNodeRep : public GameNodeRep {
   friend class GamePlayerRep;
   friend class PureBehavProfile;
   template <class T> friend class MixedBehavProfile;
+  template <class T> friend class TreeMixedStrategyProfileRep;
   
 protected:
   int number; 
@@ -154,7 +160,8 @@ public:
   virtual Game GetGame(void) const; 
 
   virtual const std::string &GetLabel(void) const { return m_label; } 
-  virtual void SetLabel(const std::string &p_label) { m_label = p_label; }
+  virtual void SetLabel(const std::string &p_label)
+  { CheckMutable(); m_label = p_label; }
 
   virtual int GetNumber(void) const { return number; }
   virtual int NumberInInfoset(void) const
@@ -196,18 +203,130 @@ public:
 };
 
 
+///
+/// A read-only snapshot of a game tree in flat arrays, for algorithms
+/// which traverse the tree many times.  Nodes are indexed by their
+/// numbers in the game; as these are assigned in depth-first order,
+/// the descendants of node n are exactly the nodes n+1 through
+/// SubtreeEnd(n), and every node comes after its parent.
+///
+/// Information sets are numbered consecutively, those of the personal
+/// players first in player order, then those of chance.
+///
+template <class T> class CompiledTree {
+  friend class GameTreeRep;
+private:
+  int m_numPlayers, m_numPersonalInfosets;
+  Array<int> m_parent, m_subtreeEnd, m_infoset, m_priorAction;
+  Array<int> m_firstChild, m_numChildren, m_children;
+  Array<int> m_outcome;
+  Array<T> m_moveProbs, m_payoffs;
+  Array<int> m_infosetPlayer, m_infosetNumber, m_playerOffset;
+  Array<int> m_firstMember, m_members;
+
+public:
+  /// @name Nodes
+  //@{
+  /// Returns the number of nodes in the tree
+  int NumNodes(void) const { return m_parent.Length(); }
+  /// Returns the parent of node n, or zero for the root
+  int GetParent(int n) const { return m_parent[n]; }
+  /// Returns the last node in the subtree rooted at node n
+  int SubtreeEnd(int n) const { return m_subtreeEnd[n]; }
+  /// Returns the number of children of node n
+  int NumChildren(int n) const { return m_numChildren[n]; }
+  /// Returns the child of node n reached by its i'th action
+  int GetChild(int n, int i) const { return m_children[m_firstChild[n] + i - 1]; }
+  /// Returns the information set at node n, or zero at a terminal node
+  int GetInfoset(int n) const { return m_infoset[n]; }
+  /// Returns the number of the action leading to node n from its parent
+  int GetPriorAction(int n) const { return m_priorAction[n]; }
+  /// Returns the probability of the chance move leading to node n,
+  /// or one if n is not reached by a chance move
+  const T &GetMoveProb(int n) const { return m_moveProbs[n]; }
+  //@}
+
+  /// @name Outcomes
+  //@{
+  /// Returns the number of players
+  int NumPlayers(void) const { return m_numPlayers; }
+  /// Returns true if an outcome is attached to node n
+  bool HasOutcome(int n) const { return m_outcome[n] > 0; }
+  /// Returns the payoff to player pl of the outcome attached to node n
+  const T &GetPayoff(int n, int pl) const 
+  { return m_payoffs[(m_outcome[n] - 1) * m_numPlayers + pl]; }
+  //@}
+
+  /// @name Information sets
+  //@{
+  /// Returns the number of information sets, including those of chance
+  int NumInfosets(void) const { return m_infosetPlayer.Length(); }
+  /// Returns the number of information sets of the personal players
+  int NumPersonalInfosets(void) const { return m_numPersonalInfosets; }
+  /// Returns the player at information set k, zero for chance
+  int GetInfosetPlayer(int k) const { return m_infosetPlayer[k]; }
+  /// Returns the number of information set k within its player
+  int GetInfosetNumber(int k) const { return m_infosetNumber[k]; }
+  /// Returns the index of player pl's iset'th information set
+  int GetInfosetIndex(int pl, int iset) const 
+  { return m_playerOffset[pl] + iset; }
+  /// Returns the number of nodes in information set k
+  int NumMembers(int k) const { return m_firstMember[k+1] - m_firstMember[k]; }
+  /// Returns the i'th node in information set k, in increasing order
+  int GetMember(int k, int i) const { return m_members[m_firstMember[k] + i - 1]; }
+  //@}
+};
+
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
   friend class GameTreeActionRep;
+  friend class TreePureStrategyProfileRep;
 protected:
   mutable bool m_computedValues;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
 
+  /// @name Compiled trees
+  //@{
+  /// Built on demand and discarded whenever the game changes
+  mutable CompiledTree<double> m_doubleTree;
+  mutable CompiledTree<Rational> m_rationalTree;
+  mutable bool m_hasDoubleTree, m_hasRationalTree;
+  /// Incremented each time the compiled trees are discarded
+  mutable unsigned long m_compiledVersion;
+  //@}
+
+  /// @name Payoffs of the reduced strategic form
+  //@{
+  /// The payoffs to each player in a block of consecutive contingencies
+  struct StrategicBlock {
+    Array<Rational> m_payoffs;
+    unsigned long m_lastUse;
+  };
+  /// The blocks computed so far, by number; discarded whenever the
+  /// game changes
+  mutable std::map<long, StrategicBlock> m_strategicBlocks;
+  mutable unsigned long m_strategicClock;
+  long m_strategicCacheSize;
+
+  /// Returns true if payoffs of contingencies are to be cached
+  bool UseStrategicCache(void) const
+  { return (m_strategicCacheSize > 0 && !IsFrozen()); }
+  /// Returns the payoffs to the players in the contingency
+  const Rational *GetStrategicPayoffs(const Array<GameStrategy> &) const;
+  void FillStrategicBlock(long p_first, long p_count,
+			  Array<Rational> &p_payoffs) const;
+  /// Writes the payoffs of all contingencies, as in an .nfg file
+  void WriteStrategicPayoffs(GameFileWriter &) const;
+  //@}
+
   /// @name Private auxiliary functions
   //@{
   void NumberNodes(GameTreeNodeRep *, int &);
+  template <class T> void BuildCompiledTree(CompiledTree<T> &) const;
+  template <class T> void CompileNode(CompiledTree<T> &, GameTreeNodeRep *,
+				      const Array<int> &, int &) const;
   //@}
 
   /// @name Managing the representation
@@ -217,6 +336,8 @@ protected:
   virtual void ClearComputedValues(void) const;
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return m_computedValues; }
+  /// Discard the compiled trees
+  virtual void ClearPayoffTables(void) const;
   //@}
 
 public: 
@@ -227,6 +348,14 @@ public:
   virtual Game Copy(void) const;
   //@}
 
+  /// @name Sharing the game between threads
+  //@{
+  /// Build the reduced strategic form and the compiled trees, and mark
+  /// the game, including its nodes, information sets and actions, as
+  /// read-only
+  virtual void Freeze(void);
+  //@}
+
   /// @name General data access
   //@{
   virtual bool IsTree(void) const { return true; }
@@ -250,6 +379,30 @@ public:
   int NumNodes(void) const;
   //@}
 
+  /// @name Compiled trees
+  //@{
+  /// \brief Returns a flat snapshot of the tree
+  ///
+  /// The snapshot is built the first time it is requested, and is
+  /// invalidated by any change to the game.
+  template <class T> const CompiledTree<T> &GetCompiledTree(void) const;
+  //@}
+
+  /// @name Payoffs of the reduced strategic form
+  //@{
+  /// \brief Sets the number of contingencies whose payoffs are kept
+  ///
+  /// Payoffs to pure strategy profiles are computed on demand, for a
+  /// block of consecutive contingencies at a time, in the order in
+  /// which they are listed in a strategic game file.  Up to the given
+  /// number of contingencies are kept; beyond this, the blocks used
+  /// least recently are discarded.  A size of zero computes each payoff
+  /// from the tree as requested.  Payoffs are not kept for frozen games.
+  void SetStrategicCacheSize(long p_contingencies);
+  /// Returns the number of contingencies whose payoffs are kept
+  long GetStrategicCacheSize(void) const { return m_strategicCacheSize; }
+  //@}
+
   virtual void DeleteOutcome(const GameOutcome &);
 
   /// @name Writing data files
@@ -287,6 +440,9 @@ public:
 
 };
 
+template<> const CompiledTree<double> &GameTreeRep::GetCompiledTree(void) const;
+template<> const CompiledTree<Rational> &GameTreeRep::GetCompiledTree(void) const;
+
 }
 
 
@@ -68,19 +68,20 @@ long lg(unsigned long x)
 
 /*
  Sizes of shifts for multiple-precision arithmetic.
- These should not be changed unless Integer representation
- as unsigned shorts is changed in the implementation files.
+ These follow from the choice of IntegerDigit in integer.h, which is
+ half the width of an unsigned long, so that the product of two digits
+ plus a carry can always be formed exactly in an unsigned long.
 */
 
-#define I_SHIFT         (sizeof(short) * CHAR_BIT)
+#define I_SHIFT         (sizeof(IntegerDigit) * CHAR_BIT)
 #define I_RADIX         ((unsigned long)(1L << I_SHIFT))
 #define I_MAXNUM        ((unsigned long)((I_RADIX - 1)))
 #define I_MINNUM        ((unsigned long)(I_RADIX >> 1))
 #define I_POSITIVE      1
 #define I_NEGATIVE      0
 
-/* All routines assume SHORT_PER_LONG > 1 */
-#define SHORT_PER_LONG  ((unsigned)(((sizeof(long) + sizeof(short) - 1) / sizeof(short))))
+/* All routines assume DIGITS_PER_LONG > 1 */
+#define DIGITS_PER_LONG  ((unsigned)(((sizeof(long) + sizeof(IntegerDigit) - 1) / sizeof(IntegerDigit))))
 #define CHAR_PER_LONG   ((unsigned)sizeof(long))
 
 /*
@@ -88,7 +89,7 @@ long lg(unsigned long x)
 */
 
 #define MIN_INTREP_SIZE   16
-#define MAX_INTREP_SIZE   I_MAXNUM
+#define MAX_INTREP_SIZE   USHRT_MAX
 
 #ifndef MALLOC_MIN_OVERHEAD
 #define MALLOC_MIN_OVERHEAD 4
@@ -103,9 +104,9 @@ static IntegerRep _MinusOneRep = {1, 0, 0, {1}};
 
 // get low bits
 
-inline static unsigned short extract(unsigned long x)
+inline static IntegerDigit extract(unsigned long x)
 {
-  return (unsigned short) (x & I_MAXNUM);
+  return (IntegerDigit) (x & I_MAXNUM);
 }
 
 // transfer high bits to low
@@ -122,15 +123,29 @@ inline static unsigned long up(unsigned long x)
   return x << I_SHIFT;
 }
 
+// magnitude below which a long converts exactly to a double
+#define I_DBLEXACT  (ldexp(1.0, DBL_MANT_DIG))
+
+// true if x / y and x % y can be done in a long
+inline static bool div_long(long x, long y)
+{
+  return y != 0 && (y != -1 || x != LONG_MIN);
+}
+
 // compare two equal-length reps
+// (digits are as wide as an int, so compare rather than subtract)
 
-static int docmp(const unsigned short* x, const unsigned short* y, int l)
+static int docmp(const IntegerDigit* x, const IntegerDigit* y, int l)
 {
-  int diff = 0;
-  const unsigned short* xs = &(x[l]);
-  const unsigned short* ys = &(y[l]);
-  while (l-- > 0 && (diff = (*--xs) - (*--ys)) == 0);
-  return diff;
+  const IntegerDigit* xs = &(x[l]);
+  const IntegerDigit* ys = &(y[l]);
+  while (l-- > 0)
+  {
+    --xs;  --ys;
+    if (*xs != *ys)
+      return (*xs > *ys) ? 1 : -1;
+  }
+  return 0;
 }
 
 // figure out max length of result of +, -, etc.
@@ -145,7 +160,7 @@ inline static int calc_len(int len1, int len2, int pad)
 static void Icheck(IntegerRep* rep)
 {
   int l = rep->len;
-  const unsigned short* p = &(rep->s[l]);
+  const IntegerDigit* p = &(rep->s[l]);
   while (l > 0 && *--p == 0) --l;
   if ((rep->len = l) == 0) rep->sgn = I_POSITIVE;
 }
@@ -155,14 +170,14 @@ static void Icheck(IntegerRep* rep)
 
 static void Iclear_from(IntegerRep* rep, int p)
 {
-  unsigned short* cp = &(rep->s[p]);
-  const unsigned short* cf = &(rep->s[rep->len]);
+  IntegerDigit* cp = &(rep->s[p]);
+  const IntegerDigit* cf = &(rep->s[rep->len]);
   while(cp < cf) *cp++ = 0;
 }
 
 // copy parts of a rep
 
-void scpy(const unsigned short* src, unsigned short* dest,int nb)
+void scpy(const IntegerDigit* src, IntegerDigit* dest,int nb)
 {
   while (--nb >= 0) *dest++ = *src++;
 }
@@ -180,21 +195,21 @@ static inline void nonnil(const IntegerRep* rep)
 
 static IntegerRep* Inew(int newlen)
 {
-  unsigned int siz = sizeof(IntegerRep) + newlen * sizeof(short) + 
+  unsigned int siz = sizeof(IntegerRep) + newlen * sizeof(IntegerDigit) + 
     MALLOC_MIN_OVERHEAD;
   unsigned int allocsiz = MIN_INTREP_SIZE;
   while (allocsiz < siz) allocsiz <<= 1;  // find a power of 2
   allocsiz -= MALLOC_MIN_OVERHEAD;
-  //assert((unsigned long) allocsiz < MAX_INTREP_SIZE * sizeof(short));
+  //assert((unsigned long) allocsiz < MAX_INTREP_SIZE * sizeof(IntegerDigit));
     
   IntegerRep* rep = (IntegerRep *) new char[allocsiz];
-  rep->sz = (allocsiz - sizeof(IntegerRep) + sizeof(short)) / sizeof(short);
+  rep->sz = (allocsiz - sizeof(IntegerRep) + sizeof(IntegerDigit)) / sizeof(IntegerDigit);
   return rep;
 }
 
 // allocate: use the bits in src if non-null, clear the rest
 
-IntegerRep* Ialloc(IntegerRep* old, const unsigned short* src, int srclen, int newsgn,
+IntegerRep* Ialloc(IntegerRep* old, const IntegerDigit* src, int srclen, int newsgn,
               int newlen)
 {
   IntegerRep* rep;
@@ -238,7 +253,7 @@ IntegerRep* Icalloc(IntegerRep* old, int newlen)
 IntegerRep* Iresize(IntegerRep* old, int newlen)
 {
   IntegerRep* rep;
-  unsigned short oldlen;
+  int oldlen;
   if (old == 0)
   {
     oldlen = 0;
@@ -316,9 +331,9 @@ IntegerRep* Icopy_long(IntegerRep* old, long x)
 
 IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
 {
-  unsigned short src[SHORT_PER_LONG];
+  IntegerDigit src[DIGITS_PER_LONG];
   
-  unsigned short srclen = 0;
+  int srclen = 0;
   while (x != 0)
   {
     src[srclen++] = extract(x);
@@ -377,16 +392,16 @@ IntegerRep* Icopy_one(IntegerRep* old, int newsgn)
 
 long Itolong(const IntegerRep* rep)
 { 
-  if ((unsigned)(rep->len) > (unsigned)(SHORT_PER_LONG))
+  if ((unsigned)(rep->len) > (unsigned)(DIGITS_PER_LONG))
     return (rep->sgn == I_POSITIVE) ? LONG_MAX : LONG_MIN;
   else if (rep->len == 0)
     return 0;
-  else if ((unsigned)(rep->len) < (unsigned)(SHORT_PER_LONG))
+  else if ((unsigned)(rep->len) < (unsigned)(DIGITS_PER_LONG))
   {
     unsigned long a = rep->s[rep->len-1];
 #ifndef __BCC55__
     // This condition is always false under BCC55
-    if (SHORT_PER_LONG > 2) // normally optimized out
+    if (DIGITS_PER_LONG > 2) // normally optimized out
     {
 		for (int i = rep->len - 2; i >= 0; --i)
 		  a = up(a) | rep->s[i];
@@ -396,17 +411,17 @@ long Itolong(const IntegerRep* rep)
   }
   else 
   {
-    unsigned long a = rep->s[SHORT_PER_LONG - 1];
+    unsigned long a = rep->s[DIGITS_PER_LONG - 1];
     if (a >= I_MINNUM)
       return (rep->sgn == I_POSITIVE) ? LONG_MAX : LONG_MIN;
     else
     {
-      a = up(a) | rep->s[SHORT_PER_LONG - 2];
+      a = up(a) | rep->s[DIGITS_PER_LONG - 2];
 #ifndef __BCC55__
       // This condition is always false under BCC55
-      if (SHORT_PER_LONG > 2)
+      if (DIGITS_PER_LONG > 2)
       {
-		  for (int i = SHORT_PER_LONG - 3; i >= 0; --i)
+		  for (int i = DIGITS_PER_LONG - 3; i >= 0; --i)
 			 a = up(a) | rep->s[i];
       }
 #endif  // __BCC55__
@@ -421,15 +436,15 @@ long Itolong(const IntegerRep* rep)
 int Iislong(const IntegerRep* rep)
 {
   unsigned int l = rep->len;
-  if (l < SHORT_PER_LONG)
+  if (l < DIGITS_PER_LONG)
     return 1;
-  else if (l > SHORT_PER_LONG)
+  else if (l > DIGITS_PER_LONG)
     return 0;
-  else if ((unsigned)(rep->s[SHORT_PER_LONG - 1]) < (unsigned)(I_MINNUM))
+  else if ((unsigned)(rep->s[DIGITS_PER_LONG - 1]) < (unsigned)(I_MINNUM))
     return 1;
-  else if (rep->sgn == I_NEGATIVE && rep->s[SHORT_PER_LONG - 1] == I_MINNUM)
+  else if (rep->sgn == I_NEGATIVE && rep->s[DIGITS_PER_LONG - 1] == I_MINNUM)
   {
-    for (unsigned int i = 0; i < SHORT_PER_LONG - 1; ++i)
+    for (unsigned int i = 0; i < DIGITS_PER_LONG - 1; ++i)
       if (rep->s[i] != 0)
         return 0;
     return 1;
@@ -446,7 +461,7 @@ double Itodouble(const IntegerRep* rep)
   double bound = DBL_MAX / 2.0;
   for (int i = rep->len - 1; i >= 0; --i)
   {
-	 unsigned short a = (unsigned short) (I_RADIX >> 1);
+	 IntegerDigit a = (IntegerDigit) (I_RADIX >> 1);
 	 while (a != 0)
     {
       if (d >= bound)
@@ -473,7 +488,7 @@ int Iisdouble(const IntegerRep* rep)
   double bound = DBL_MAX / 2.0;
   for (int i = rep->len - 1; i >= 0; --i)
   {
-	 unsigned short a = (unsigned short) (I_RADIX >> 1);
+	 IntegerDigit a = (IntegerDigit) (I_RADIX >> 1);
     while (a != 0)
     {
       if (d > bound || (d == bound && (i > 0 || (rep->s[i] & a))))
@@ -499,12 +514,14 @@ double ratio(const Integer& num, const Integer& den)
     return d1;
   else      // use as much precision as available for fractional part
   {
+    LongIntegerRep denb, rb;
+    const IntegerRep *dr = den.GetRep(denb), *rr = r.GetRep(rb);
     double  d2 = 0.0;
     double  d3 = 0.0; 
     int cont = 1;
-    for (int i = den.rep->len - 1; i >= 0 && cont; --i)
+    for (int i = dr->len - 1; i >= 0 && cont; --i)
     {
-		unsigned short a = (unsigned short) (I_RADIX >> 1);
+		IntegerDigit a = (IntegerDigit) (I_RADIX >> 1);
       while (a != 0)
       {
         if (d2 + 1.0 == d2) // out of precision when we get here
@@ -514,13 +531,13 @@ double ratio(const Integer& num, const Integer& den)
         }
 
         d2 *= 2.0;
-        if (den.rep->s[i] & a)
+        if (dr->s[i] & a)
           d2 += 1.0;
 
-        if (i < r.rep->len)
+        if (i < rr->len)
         {
           d3 *= 2.0;
-          if (r.rep->s[i] & a)
+          if (rr->s[i] & a)
             d3 += 1.0;
         }
 
@@ -554,12 +571,7 @@ int ucompare(const IntegerRep* x, const IntegerRep* y)
 {
   int diff = x->len - y->len;
   if (diff == 0)
-  {
-    int l = x->len;
-    const unsigned short* xs = &(x->s[l]);
-    const unsigned short* ys = &(y->s[l]);
-    while (l-- > 0 && (diff = (*--xs) - (*--ys)) == 0);
-  }
+    diff = docmp(x->s, y->s, x->len);
   return diff;
 }
 
@@ -583,10 +595,10 @@ int compare(const IntegerRep* x, long  y)
     int diff = xsgn - ysgn;
     if (diff == 0)
     {
-      diff = xl - SHORT_PER_LONG;
+      diff = xl - DIGITS_PER_LONG;
       if (diff <= 0)
       {
-        unsigned short tmp[SHORT_PER_LONG];
+        IntegerDigit tmp[DIGITS_PER_LONG];
         int yl = 0;
         while (uy != 0)
         {
@@ -612,10 +624,10 @@ int ucompare(const IntegerRep* x, long  y)
   else
   {
     unsigned long uy = (y >= 0)? y : -y;
-    int diff = xl - SHORT_PER_LONG;
+    int diff = xl - DIGITS_PER_LONG;
     if (diff <= 0)
     {
-      unsigned short tmp[SHORT_PER_LONG];
+      IntegerDigit tmp[DIGITS_PER_LONG];
       int yl = 0;
       while (uy != 0)
       {
@@ -660,11 +672,11 @@ IntegerRep* add(const IntegerRep* x, int negatex,
     else
       r = Icalloc(r, calc_len(xl, yl, 1));
     r->sgn = xsgn;
-    unsigned short* rs = r->s;
-    const unsigned short* as;
-    const unsigned short* bs;
-    const unsigned short* topa;
-    const unsigned short* topb;
+    IntegerDigit* rs = r->s;
+    const IntegerDigit* as;
+    const IntegerDigit* bs;
+    const IntegerDigit* topa;
+    const IntegerDigit* topb;
     if (xl >= yl)
     {
       as =  (xrsame)? r->s : x->s;
@@ -709,11 +721,11 @@ IntegerRep* add(const IntegerRep* x, int negatex,
         r = Iresize(r, calc_len(xl, yl, 0));
       else
         r = Icalloc(r, calc_len(xl, yl, 0));
-      unsigned short* rs = r->s;
-      const unsigned short* as;
-      const unsigned short* bs;
-      const unsigned short* topa;
-      const unsigned short* topb;
+      IntegerDigit* rs = r->s;
+      const IntegerDigit* as;
+      const IntegerDigit* bs;
+      const IntegerDigit* topa;
+      const IntegerDigit* topb;
       if (comp > 0)
       {
         as =  (xrsame)? r->s : x->s;
@@ -770,13 +782,13 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
   else if (xsgn == ysgn)
   {
     if (xrsame)
-      r = Iresize(r, calc_len(xl, SHORT_PER_LONG, 1));
+      r = Iresize(r, calc_len(xl, DIGITS_PER_LONG, 1));
     else
-      r = Icalloc(r, calc_len(xl, SHORT_PER_LONG, 1));
+      r = Icalloc(r, calc_len(xl, DIGITS_PER_LONG, 1));
     r->sgn = xsgn;
-    unsigned short* rs = r->s;
-    const unsigned short* as =  (xrsame)? r->s : x->s;
-    const unsigned short* topa = &(as[xl]);
+    IntegerDigit* rs = r->s;
+    const IntegerDigit* as =  (xrsame)? r->s : x->s;
+    const IntegerDigit* topa = &(as[xl]);
     unsigned long sum = 0;
     while (as < topa && uy != 0)
     {
@@ -786,6 +798,13 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
       *rs++ = extract(sum);
       sum = down(sum);
     }
+    while (uy != 0)             // y has more digits than x
+    {
+      sum += extract(uy);
+      uy = down(uy);
+      *rs++ = extract(sum);
+      sum = down(sum);
+    }
     while (sum != 0 && as < topa)
     {
       sum += (unsigned long)(*as++);
@@ -800,7 +819,7 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
   }
   else
   {
-    unsigned short tmp[SHORT_PER_LONG];
+    IntegerDigit tmp[DIGITS_PER_LONG];
     int yl = 0;
     while (uy != 0)
     {
@@ -818,11 +837,11 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
         r = Iresize(r, calc_len(xl, yl, 0));
       else
         r = Icalloc(r, calc_len(xl, yl, 0));
-      unsigned short* rs = r->s;
-      const unsigned short* as;
-      const unsigned short* bs;
-      const unsigned short* topa;
-      const unsigned short* topb;
+      IntegerDigit* rs = r->s;
+      const IntegerDigit* as;
+      const IntegerDigit* bs;
+      const IntegerDigit* topa;
+      const IntegerDigit* topb;
       if (comp > 0)
       {
         as =  (xrsame)? r->s : x->s;
@@ -886,15 +905,15 @@ IntegerRep* multiply(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
       r = Iresize(r, rl);
     else
       r = Icalloc(r, rl);
-    unsigned short* rs = r->s;
-    unsigned short* topr = &(rs[rl]);
+    IntegerDigit* rs = r->s;
+    IntegerDigit* topr = &(rs[rl]);
 
     // use best inner/outer loop params given constraints
-    unsigned short* currentr;
-    const unsigned short* bota;
-    const unsigned short* as;
-    const unsigned short* botb;
-    const unsigned short* topb;
+    IntegerDigit* currentr;
+    const IntegerDigit* bota;
+    const IntegerDigit* as;
+    const IntegerDigit* botb;
+    const IntegerDigit* topb;
     if (xrsame)                 
     { 
       currentr = &(rs[xl-1]);
@@ -931,12 +950,12 @@ IntegerRep* multiply(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
     while (as >= bota)
     {
       unsigned long ai = (unsigned long)(*as--);
-      unsigned short* rs = currentr--;
+      IntegerDigit* rs = currentr--;
       *rs = 0;
       if (ai != 0)
       {
         unsigned long sum = 0;
-        const unsigned short* bs = botb;
+        const IntegerDigit* bs = botb;
         while (bs < topb)
         {
           sum += ai * (unsigned long)(*bs++) + (unsigned long)(*rs);
@@ -955,24 +974,24 @@ IntegerRep* multiply(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
   else                          // x, y, and r same; compute over diagonals
   {
     r = Iresize(r, rl);
-    unsigned short* botr = r->s;
-    unsigned short* topr = &(botr[rl]);
-    unsigned short* rs =   &(botr[rl - 2]);
+    IntegerDigit* botr = r->s;
+    IntegerDigit* topr = &(botr[rl]);
+    IntegerDigit* rs =   &(botr[rl - 2]);
 
-    const unsigned short* bota = (xrsame)? botr : x->s;
-    const unsigned short* loa =  &(bota[xl - 1]);
-    const unsigned short* hia =  loa;
+    const IntegerDigit* bota = (xrsame)? botr : x->s;
+    const IntegerDigit* loa =  &(bota[xl - 1]);
+    const IntegerDigit* hia =  loa;
 
     for (; rs >= botr; --rs)
     {
-      const unsigned short* h = hia;
-      const unsigned short* l = loa;
+      const IntegerDigit* h = hia;
+      const IntegerDigit* l = loa;
       unsigned long prod = (unsigned long)(*h) * (unsigned long)(*l);
       *rs = 0;
 
       for(;;)
       {
-        unsigned short* rt = rs;
+        IntegerDigit* rt = rs;
         unsigned long sum = prod + (unsigned long)(*rt);
         *rt++ = extract(sum);
         sum = down(sum);
@@ -1028,7 +1047,7 @@ IntegerRep* multiply(const IntegerRep* x, long y, IntegerRep* r)
     int ysgn = y >= 0;
     int rsgn = x->sgn == ysgn;
     unsigned long uy = (ysgn)? y : -y;
-    unsigned short tmp[SHORT_PER_LONG];
+    IntegerDigit tmp[DIGITS_PER_LONG];
     int yl = 0;
     while (uy != 0)
     {
@@ -1043,13 +1062,13 @@ IntegerRep* multiply(const IntegerRep* x, long y, IntegerRep* r)
     else
       r = Icalloc(r, rl);
 
-    unsigned short* rs = r->s;
-    unsigned short* topr = &(rs[rl]);
-    unsigned short* currentr;
-    const unsigned short* bota;
-    const unsigned short* as;
-    const unsigned short* botb;
-    const unsigned short* topb;
+    IntegerDigit* rs = r->s;
+    IntegerDigit* topr = &(rs[rl]);
+    IntegerDigit* currentr;
+    const IntegerDigit* bota;
+    const IntegerDigit* as;
+    const IntegerDigit* botb;
+    const IntegerDigit* topb;
 
     if (xrsame)
     { 
@@ -1079,12 +1098,12 @@ IntegerRep* multiply(const IntegerRep* x, long y, IntegerRep* r)
     while (as >= bota)
     {
       unsigned long ai = (unsigned long)(*as--);
-      unsigned short* rs = currentr--;
+      IntegerDigit* rs = currentr--;
       *rs = 0;
       if (ai != 0)
       {
         unsigned long sum = 0;
-        const unsigned short* bs = botb;
+        const IntegerDigit* bs = botb;
         while (bs < topb)
         {
           sum += ai * (unsigned long)(*bs++) + (unsigned long)(*rs);
@@ -1108,31 +1127,31 @@ IntegerRep* multiply(const IntegerRep* x, long y, IntegerRep* r)
 
 // main division routine
 
-static void do_divide(unsigned short* rs,
-                      const unsigned short* ys, int yl,
-                      unsigned short* qs, int ql)
+static void do_divide(IntegerDigit* rs,
+                      const IntegerDigit* ys, int yl,
+                      IntegerDigit* qs, int ql)
 {
-  const unsigned short* topy = &(ys[yl]);
-  unsigned short d1 = ys[yl - 1];
-  unsigned short d2 = ys[yl - 2];
+  const IntegerDigit* topy = &(ys[yl]);
+  IntegerDigit d1 = ys[yl - 1];
+  IntegerDigit d2 = ys[yl - 2];
  
   int l = ql - 1;
   int i = l + yl;
   
   for (; l >= 0; --l, --i)
   {
-    unsigned short qhat;       // guess q
+    IntegerDigit qhat;       // guess q
     if (d1 == rs[i])
-		qhat = (unsigned short) I_MAXNUM;
+		qhat = (IntegerDigit) I_MAXNUM;
     else
     {
       unsigned long lr = up((unsigned long)rs[i]) | rs[i-1];
-		qhat = (unsigned short) (lr / d1);
+		qhat = (IntegerDigit) (lr / d1);
     }
 
     for(;;)     // adjust q, use docmp to avoid overflow problems
     {
-      unsigned short ts[3];
+      IntegerDigit ts[3];
       unsigned long prod = (unsigned long)d2 * (unsigned long)qhat;
       ts[0] = extract(prod);
       prod = down(prod) + (unsigned long)d1 * (unsigned long)qhat;
@@ -1146,8 +1165,8 @@ static void do_divide(unsigned short* rs,
     
     // multiply & subtract
     
-    const unsigned short* yt = ys;
-    unsigned short* rt = &(rs[l]);
+    const IntegerDigit* yt = ys;
+    IntegerDigit* rt = &(rs[l]);
     unsigned long prod = 0;
     unsigned long hi = 1;
     while (yt < topy)
@@ -1184,16 +1203,16 @@ static void do_divide(unsigned short* rs,
 // divide by single digit, return remainder
 // if q != 0, then keep the result in q, else just compute rem
 
-static int unscale(const unsigned short* x, int xl, unsigned short y,
-                   unsigned short* q)
+static IntegerDigit unscale(const IntegerDigit* x, int xl, IntegerDigit y,
+                            IntegerDigit* q)
 {
   if (xl == 0 || y == 1)
     return 0;
   else if (q != 0)
   {
-    unsigned short* botq = q;
-    unsigned short* qs = &(botq[xl - 1]);
-    const unsigned short* xs = &(x[xl - 1]);
+    IntegerDigit* botq = q;
+    IntegerDigit* qs = &(botq[xl - 1]);
+    const IntegerDigit* xs = &(x[xl - 1]);
     unsigned long rem = 0;
     while (qs >= botq)
     {
@@ -1202,13 +1221,12 @@ static int unscale(const unsigned short* x, int xl, unsigned short y,
       *qs-- = extract(u);
       rem -= u * y;
     }
-    int r = extract(rem);
-    return r;
+    return extract(rem);
   }
   else                          // same loop, a bit faster if just need rem
   {
-    const unsigned short* botx = x;
-    const unsigned short* xs = &(botx[xl - 1]);
+    const IntegerDigit* botx = x;
+    const IntegerDigit* xs = &(botx[xl - 1]);
     unsigned long rem = 0;
     while (xs >= botx)
     {
@@ -1216,8 +1234,7 @@ static int unscale(const unsigned short* x, int xl, unsigned short y,
       unsigned long u = rem / y;
       rem -= u * y;
     }
-    int r = extract(rem);
-    return r;
+    return extract(rem);
   }
 }
 
@@ -1251,7 +1268,7 @@ IntegerRep* div(const IntegerRep* x, const IntegerRep* y, IntegerRep* q)
   {
     IntegerRep* yy = 0;
     IntegerRep* r  = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + y->s[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) y->s[yl - 1]));
     if (prescale != 1 || y == q)
     {
       yy = multiply(y, ((long)prescale & I_MAXNUM), yy);
@@ -1285,7 +1302,7 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
     throw Gambit::ZeroDivideException();
   }
 
-  unsigned short ys[SHORT_PER_LONG];
+  IntegerDigit ys[DIGITS_PER_LONG];
   unsigned long u;
   int ysgn = y >= 0;
   if (ysgn)
@@ -1319,7 +1336,7 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
   else
   {
     IntegerRep* r  = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + ys[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) ys[yl - 1]));
     if (prescale != 1)
     {
       unsigned long prod = (unsigned long)prescale * (unsigned long)ys[0];
@@ -1349,14 +1366,22 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
 
 void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
 {
-  const IntegerRep* x = Ix.rep;
+  if (Ix.rep == 0 && div_long(Ix.m_value, y))
+  {
+    long x = Ix.m_value;
+    Iq.SetValue(x / y);
+    rem = x % y;
+    return;
+  }
+  LongIntegerRep xb;
+  const IntegerRep* x = Ix.GetRep(xb);
   nonnil(x);
   IntegerRep* q = Iq.rep;
   int xl = x->len;
   if (y == 0) {
     throw Gambit::ZeroDivideException();
   }
-  unsigned short ys[SHORT_PER_LONG];
+  IntegerDigit ys[DIGITS_PER_LONG];
   unsigned long u;
   int ysgn = y >= 0;
   if (ysgn)
@@ -1394,7 +1419,7 @@ void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
   else
   {
     IntegerRep* r  = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + ys[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) ys[yl - 1]));
     if (prescale != 1)
     {
       unsigned long prod = (unsigned long)prescale * (unsigned long)ys[0];
@@ -1424,19 +1449,28 @@ void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
     rem = Itolong(r);
     if (!STATIC_IntegerRep(r)) delete r;
   }
-  rem = abs(rem).as_long();
+  if (rem < 0) rem = -rem;
   if (xsgn == I_NEGATIVE) rem = -rem;
   q->sgn = samesign;
   Icheck(q);
   Iq.rep = q;
+  Iq.Normalize();
 }
 
 
 void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
 {
-  const IntegerRep* x = Ix.rep;
+  if (Ix.rep == 0 && Iy.rep == 0 && div_long(Ix.m_value, Iy.m_value))
+  {
+    long x = Ix.m_value, y = Iy.m_value;
+    Iq.SetValue(x / y);
+    Ir.SetValue(x % y);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  const IntegerRep* x = Ix.GetRep(xb);
   nonnil(x);
-  const IntegerRep* y = Iy.rep;
+  const IntegerRep* y = Iy.GetRep(yb);
   nonnil(y);
   IntegerRep* q = Iq.rep;
   IntegerRep* r = Ir.rep;
@@ -1465,7 +1499,7 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
   else if (yl == 1)
   {
     q = Icopy(q, x);
-    int rem =  unscale(q->s, q->len, y->s[0], q->s);
+    long rem = unscale(q->s, q->len, y->s[0], q->s);
     r = Icopy_long(r, rem);
     if (rem != 0)
       r->sgn = xsgn;
@@ -1473,7 +1507,7 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
   else
   {
     IntegerRep* yy = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + y->s[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) y->s[yl - 1]));
     if (prescale != 1 || y == q || y == r)
     {
       yy = multiply(y, ((long)prescale & I_MAXNUM), yy);
@@ -1484,6 +1518,7 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
       yy = (IntegerRep*)y;
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
 
     int ql = xl - yl + 1;
@@ -1501,8 +1536,10 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
   q->sgn = samesign;
   Icheck(q);
   Iq.rep = q;
+  Iq.Normalize();
   Icheck(r);
   Ir.rep = r;
+  Ir.Normalize();
 }
 
 IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
@@ -1525,7 +1562,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
     r = Icopy_zero(r);
   else if (yl == 1)
   {
-    int rem = unscale(x->s, xl, y->s[0], 0);
+    long rem = unscale(x->s, xl, y->s[0], 0);
     r = Icopy_long(r, rem);
     if (rem != 0)
       r->sgn = xsgn;
@@ -1533,7 +1570,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
   else
   {
     IntegerRep* yy = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + y->s[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) y->s[yl - 1]));
     if (prescale != 1 || y == r)
     {
       yy = multiply(y, ((long)prescale & I_MAXNUM), yy);
@@ -1544,6 +1581,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
       yy = (IntegerRep*)y;
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
       
     do_divide(r->s, yy->s, yl, 0, xl - yl + 1);
@@ -1567,7 +1605,7 @@ IntegerRep* mod(const IntegerRep* x, long y, IntegerRep* r)
   if (y == 0) {
     throw Gambit::ZeroDivideException();
   }
-  unsigned short ys[SHORT_PER_LONG];
+  IntegerDigit ys[DIGITS_PER_LONG];
   unsigned long u;
   int ysgn = y >= 0;
   if (ysgn)
@@ -1592,14 +1630,14 @@ IntegerRep* mod(const IntegerRep* x, long y, IntegerRep* r)
     r = Icopy_zero(r);
   else if (yl == 1)
   {
-    int rem = unscale(x->s, xl, ys[0], 0);
+    long rem = unscale(x->s, xl, ys[0], 0);
     r = Icopy_long(r, rem);
     if (rem != 0)
       r->sgn = xsgn;
   }
   else
   {
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + ys[yl - 1]));
+	 IntegerDigit prescale = (IntegerDigit) (I_RADIX / (1 + (unsigned long) ys[yl - 1]));
     if (prescale != 1)
     {
       unsigned long prod = (unsigned long)prescale * (unsigned long)ys[0];
@@ -1612,6 +1650,7 @@ IntegerRep* mod(const IntegerRep* x, long y, IntegerRep* r)
     {
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
       
     do_divide(r->s, ys, yl, 0, xl - yl + 1);
@@ -1651,10 +1690,10 @@ IntegerRep* lshift(const IntegerRep* x, long y, IntegerRep* r)
     else
       r = Icalloc(r, rl);
 
-    unsigned short* botr = r->s;
-    unsigned short* rs = &(botr[rl - 1]);
-    const unsigned short* botx = (xrsame)? botr : x->s;
-    const unsigned short* xs = &(botx[xl - 1]);
+    IntegerDigit* botr = r->s;
+    IntegerDigit* rs = &(botr[rl - 1]);
+    const IntegerDigit* botx = (xrsame)? botr : x->s;
+    const IntegerDigit* xs = &(botx[xl - 1]);
     unsigned long a = 0;
     while (xs >= botx)
     {
@@ -1677,11 +1716,11 @@ IntegerRep* lshift(const IntegerRep* x, long y, IntegerRep* r)
       else
         r = Icalloc(r, rl);
       int rw = I_SHIFT - sw;
-      unsigned short* rs = r->s;
-      unsigned short* topr = &(rs[rl]);
-      const unsigned short* botx = (xrsame)? rs : x->s;
-      const unsigned short* xs =  &(botx[bw]);
-      const unsigned short* topx = &(botx[xl]);
+      IntegerDigit* rs = r->s;
+      IntegerDigit* topr = &(rs[rl]);
+      const IntegerDigit* botx = (xrsame)? rs : x->s;
+      const IntegerDigit* xs =  &(botx[bw]);
+      const IntegerDigit* topx = &(botx[xl]);
       unsigned long a = (unsigned long)(*xs++) >> sw;
       while (xs < topx)
       {
@@ -1690,7 +1729,7 @@ IntegerRep* lshift(const IntegerRep* x, long y, IntegerRep* r)
         a = down(a);
       }
       *rs++ = extract(a);
-      if (xrsame) topr = (unsigned short*)topx;
+      if (xrsame) topr = (IntegerDigit*)topx;
       while (rs < topr)
         *rs++ = 0;
     }
@@ -1723,11 +1762,11 @@ IntegerRep* bitop(const IntegerRep* x, const IntegerRep* y, IntegerRep* r, char
   else
     r = Icalloc(r, calc_len(xl, yl, 0));
   r->sgn = xsgn;
-  unsigned short* rs = r->s;
-  unsigned short* topr = &(rs[r->len]);
-  const unsigned short* as;
-  const unsigned short* bs;
-  const unsigned short* topb;
+  IntegerDigit* rs = r->s;
+  IntegerDigit* topr = &(rs[r->len]);
+  const IntegerDigit* as;
+  const IntegerDigit* bs;
+  const IntegerDigit* topb;
   if (xl >= yl)
   {
     as = (xrsame)? rs : x->s;
@@ -1763,7 +1802,7 @@ IntegerRep* bitop(const IntegerRep* x, const IntegerRep* y, IntegerRep* r, char
 IntegerRep* bitop(const IntegerRep* x, long y, IntegerRep* r, char op)
 {
   nonnil(x);
-  unsigned short tmp[SHORT_PER_LONG];
+  IntegerDigit tmp[DIGITS_PER_LONG];
   unsigned long u;
   int newsgn = (y >= 0);
   if (newsgn)
@@ -1787,11 +1826,11 @@ IntegerRep* bitop(const IntegerRep* x, long y, IntegerRep* r, char op)
   else
 	 r = Icalloc(r, calc_len(xl, yl, 0));
   r->sgn = xsgn;
-  unsigned short* rs = r->s;
-  unsigned short* topr = &(rs[r->len]);
-  const unsigned short* as;
-  const unsigned short* bs;
-  const unsigned short* topb;
+  IntegerDigit* rs = r->s;
+  IntegerDigit* topr = &(rs[r->len]);
+  const IntegerDigit* as;
+  const IntegerDigit* bs;
+  const IntegerDigit* topb;
   if (xl >= yl)
   {
 	 as = (xrsame)? rs : x->s;
@@ -1830,15 +1869,15 @@ IntegerRep*  Compl(const IntegerRep* src, IntegerRep* r)
 {
   nonnil(src);
   r = Icopy(r, src);
-  unsigned short* s = r->s;
-  unsigned short* top = &(s[r->len - 1]);
+  IntegerDigit* s = r->s;
+  IntegerDigit* top = &(s[r->len - 1]);
   while (s < top)
   {
-    unsigned short cmp = ~(*s);
+    IntegerDigit cmp = ~(*s);
     *s++ = cmp;
   }
-  unsigned short a = *s;
-  unsigned short b = 0;
+  IntegerDigit a = *s;
+  IntegerDigit b = 0;
   while (a != 0)
   {
     b <<= 1;
@@ -1856,11 +1895,14 @@ void (setbit)(Integer& x, long b)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    int xl = x.rep ? x.rep->len : 0;
+    if (x.rep == 0)
+      x.rep = Icopy_long(0, x.m_value);
+    int xl = x.rep->len;
     if (xl <= bw)
       x.rep = Iresize(x.rep, calc_len(xl, bw+1, 0));
-    x.rep->s[bw] |= (1 << sw);
+    x.rep->s[bw] |= ((IntegerDigit) 1 << sw);
     Icheck(x.rep);
+    x.Normalize();
   }
 }
 
@@ -1869,25 +1911,25 @@ void clearbit(Integer& x, long b)
   if (b >= 0)
     {
       if (x.rep == 0)
-	x.rep = &_ZeroRep;
-      else
-	{
-	  int bw = (int) ((unsigned long)b / I_SHIFT);
-	  int sw = (int) ((unsigned long)b % I_SHIFT);
-	  if (x.rep->len > bw)
-	    x.rep->s[bw] &= ~(1 << sw);
-	}
-    Icheck(x.rep);
+	x.rep = Icopy_long(0, x.m_value);
+      int bw = (int) ((unsigned long)b / I_SHIFT);
+      int sw = (int) ((unsigned long)b % I_SHIFT);
+      if (x.rep->len > bw)
+	x.rep->s[bw] &= ~((IntegerDigit) 1 << sw);
+      Icheck(x.rep);
+      x.Normalize();
   }
 }
 
 int testbit(const Integer& x, long b)
 {
-  if (x.rep != 0 && b >= 0)
+  if (b >= 0)
   {
+    LongIntegerRep xb;
+    const IntegerRep *xr = x.GetRep(xb);
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    return (bw < x.rep->len && (x.rep->s[bw] & (1 << sw)) != 0);
+    return (bw < xr->len && (xr->s[bw] & ((IntegerDigit) 1 << sw)) != 0);
   }
   else
     return 0;
@@ -2000,7 +2042,7 @@ long lg(const IntegerRep* x)
     return 0;
 
   long l = (xl - 1) * I_SHIFT - 1;
-  unsigned short a = x->s[xl-1];
+  IntegerDigit a = x->s[xl-1];
 
   while (a != 0)
   {
@@ -2196,7 +2238,8 @@ std::string Itoa(const IntegerRep *x, int base, int width)
 
 std::ostream &operator<<(std::ostream &s, const Integer &y)
 {
-  return s << Itoa(y.rep);
+  LongIntegerRep yb;
+  return s << Itoa(y.GetRep(yb));
 }
 
 std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base, int showbase,
@@ -2214,13 +2257,13 @@ std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base,
     IntegerRep* z = Icopy(0, x);
 
     // split division by base into two parts: 
-    // first divide by biggest power of base that fits in an unsigned short,
+    // first divide by biggest power of base that fits in an IntegerDigit,
     // then use straight signed div/mods from there. 
 
     // find power
     int bpower = 1;
-    unsigned short b = base;
-	 unsigned short maxb = (unsigned short) (I_MAXNUM / base);
+    IntegerDigit b = base;
+	 IntegerDigit maxb = (IntegerDigit) (I_MAXNUM / base);
     while (b < maxb)
     {
       b *= base;
@@ -2228,7 +2271,7 @@ std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base,
     }
     for(;;)
     {
-      int rem = unscale(z->s, z->len, b, z->s);
+      long rem = unscale(z->s, z->len, b, z->s);
       Icheck(z);
       if (z->len == 0)
       {
@@ -2295,7 +2338,7 @@ std::istream &operator>>(std::istream &s, Integer& y)
 {
   char sgn = 0;
   char ch;
-  y.rep = Icopy_zero(y.rep);
+  y.SetValue(0);
 
   do  {
 	 s.get(ch);
@@ -2334,7 +2377,9 @@ std::istream &operator>>(std::istream &s, Integer& y)
 
 int Integer::OK() const
 {
-  if (rep != 0)
+  if (rep == 0)
+    return 1;
+  else
 	 {
       int l = rep->len;
       int s = rep->sgn;
@@ -2358,181 +2403,376 @@ void Integer::error(const char* msg) const
 
 
 
+// Values which fit in a long are held inline in an Integer, and the
+// procedural versions below operate on them directly when the result
+// is known to fit in a long as well.  Otherwise, the operands are
+// presented to the IntegerRep routines, and the result moved back
+// inline if it turns out to fit.
+
+const IntegerRep *Integer::GetRep(LongIntegerRep &buf) const
+{
+  if (rep != 0)
+    return rep;
+
+  IntegerRep *r = &buf.rep;
+  IntegerDigit *s = r->s;
+  unsigned long u = uabs(m_value);
+  int l = 0;
+  while (u != 0)
+  {
+    s[l++] = extract(u);
+    u = down(u);
+  }
+  r->len = l;
+  r->sz = 0;                    // static: never freed or reused
+  r->sgn = (m_value >= 0);
+  return r;
+}
+
+void Integer::SetValue(long y)
+{
+  if (rep != 0 && !STATIC_IntegerRep(rep)) delete rep;
+  rep = 0;
+  m_value = y;
+}
+
+void Integer::Normalize(void)
+{
+  if (rep != 0 && Iislong(rep))
+  {
+    m_value = Itolong(rep);
+    if (!STATIC_IntegerRep(rep)) delete rep;
+    rep = 0;
+  }
+}
+
 // The following were moved from the header file to stop BC from squealing
 // endless quantities of warnings
 
-Integer::Integer() :rep(&_ZeroRep) {}
+Integer::Integer() :rep(0), m_value(0) {}
 
-Integer::Integer(IntegerRep* r) :rep(r) {}
+Integer::Integer(IntegerRep* r) :rep(r), m_value(0) { Normalize(); }
 
-Integer::Integer(int y) :rep(Icopy_long(0, (long)y)) {}
+Integer::Integer(int y) :rep(0), m_value(y) {}
 
-Integer::Integer(long y) :rep(Icopy_long(0, y)) {}
+Integer::Integer(long y) :rep(0), m_value(y) {}
 
-Integer::Integer(unsigned long y) :rep(Icopy_ulong(0, y)) {}
+Integer::Integer(unsigned long y) 
+  :rep((y > (unsigned long) LONG_MAX) ? Icopy_ulong(0, y) : 0),
+   m_value((y > (unsigned long) LONG_MAX) ? 0 : (long) y) {}
 
-Integer::Integer(const Integer&  y) :rep(Icopy(0, y.rep)) {}
+Integer::Integer(const Integer&  y) 
+  :rep((y.rep) ? Icopy(0, y.rep) : 0), m_value(y.m_value) {}
 
 Integer::~Integer() { if (rep && !STATIC_IntegerRep(rep)) delete rep; }
 
 Integer &Integer::operator=(const Integer &y)
 {
-  rep = Icopy(rep, y.rep);
+  if (y.rep == 0)
+    SetValue(y.m_value);
+  else
+    rep = Icopy(rep, y.rep);
   return *this;
 }
 
 Integer &Integer::operator=(long y)
 {
-  rep = Icopy_long(rep, y); 
+  SetValue(y);
   return *this;
 }
 
 int Integer::initialized() const
 {
-  return rep != 0;
+  return 1;
+}
+
+double Integer::as_double() const
+{
+  // Itodouble() accumulates bit by bit, which is exact in this range
+  if (rep == 0 && uabs(m_value) < I_DBLEXACT)
+    return (double) m_value;
+  LongIntegerRep xb;
+  return Itodouble(GetRep(xb));
 }
 
 // procedural versions
 
 int compare(const Integer& x, const Integer& y)
 {
-  return compare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+    return (x.m_value < y.m_value) ? -1 : (x.m_value > y.m_value);
+  LongIntegerRep xb, yb;
+  return compare(x.GetRep(xb), y.GetRep(yb));
 }
 
 int ucompare(const Integer& x, const Integer& y)
 {
-  return ucompare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+  {
+    unsigned long ux = uabs(x.m_value), uy = uabs(y.m_value);
+    return (ux < uy) ? -1 : (ux > uy);
+  }
+  LongIntegerRep xb, yb;
+  return ucompare(x.GetRep(xb), y.GetRep(yb));
 }
 
 int compare(const Integer& x, long y)
 {
+  if (x.rep == 0)
+    return (x.m_value < y) ? -1 : (x.m_value > y);
   return compare(x.rep, y);
 }
 
 int ucompare(const Integer& x, long y)
 {
+  if (x.rep == 0)
+  {
+    unsigned long ux = uabs(x.m_value), uy = uabs(y);
+    return (ux < uy) ? -1 : (ux > uy);
+  }
   return ucompare(x.rep, y);
 }
 
 int compare(long x, const Integer& y)
 {
-  return -compare(y.rep, x);
+  return -compare(y, x);
 }
 
 int ucompare(long x, const Integer& y)
 {
-  return -ucompare(y.rep, x);
+  return -ucompare(y, x);
 }
 
 void  add(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 0, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && add_long(x.m_value, y.m_value, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = add(x.GetRep(xb), 0, y.GetRep(yb), 0, dest.rep);
+  dest.Normalize();
 }
 
 void  sub(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 1, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && sub_long(x.m_value, y.m_value, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = add(x.GetRep(xb), 0, y.GetRep(yb), 1, dest.rep);
+  dest.Normalize();
 }
 
 void  mul(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y.rep, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && mul_long(x.m_value, y.m_value, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = multiply(x.GetRep(xb), y.GetRep(yb), dest.rep);
+  dest.Normalize();
 }
 
 void  div(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = div(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && div_long(x.m_value, y.m_value))
+  {
+    dest.SetValue(x.m_value / y.m_value);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = div(x.GetRep(xb), y.GetRep(yb), dest.rep);
+  dest.Normalize();
 }
 
 void  mod(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && div_long(x.m_value, y.m_value))
+  {
+    dest.SetValue(x.m_value % y.m_value);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = mod(x.GetRep(xb), y.GetRep(yb), dest.rep);
+  dest.Normalize();
 }
 
 void  lshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 0, dest.rep);
+  lshift(x, y.as_long(), dest);
 }
 
 void  rshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 1, dest.rep);
+  lshift(x, -y.as_long(), dest);
 }
 
 void  pow(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = power(x.rep, Itolong(y.rep), dest.rep); // not incorrect
+  pow(x, y.as_long(), dest); // not incorrect
 }
 
 void  add(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y, dest.rep);
+  long r;
+  if (x.rep == 0 && add_long(x.m_value, y, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = add(x.GetRep(xb), 0, y, dest.rep);
+  dest.Normalize();
 }
 
 void  sub(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, -y, dest.rep);
+  long r;
+  if (x.rep == 0 && sub_long(x.m_value, y, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb, yb;
+  dest.rep = add(x.GetRep(xb), 0, Integer(y).GetRep(yb), 1, dest.rep);
+  dest.Normalize();
 }
 
 void  mul(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y, dest.rep);
+  long r;
+  if (x.rep == 0 && mul_long(x.m_value, y, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = multiply(x.GetRep(xb), y, dest.rep);
+  dest.Normalize();
 }
 
 void  div(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = div(x.rep, y, dest.rep);
+  if (x.rep == 0 && div_long(x.m_value, y))
+  {
+    dest.SetValue(x.m_value / y);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = div(x.GetRep(xb), y, dest.rep);
+  dest.Normalize();
 }
 
 void  mod(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y, dest.rep);
+  if (x.rep == 0 && div_long(x.m_value, y))
+  {
+    dest.SetValue(x.m_value % y);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = mod(x.GetRep(xb), y, dest.rep);
+  dest.Normalize();
 }
 
 
 void  lshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y, dest.rep);
+  // shifts act on the magnitude, as for the IntegerRep routines
+  if (x.rep == 0 && x.m_value != LONG_MIN)
+  {
+    const long bits = sizeof(long) * CHAR_BIT;
+    unsigned long u = uabs(x.m_value);
+    if (y <= 0)
+      u = (y <= -bits) ? 0 : (u >> -y);
+    else if (y < bits - 1 && u <= ((unsigned long) LONG_MAX >> y))
+      u <<= y;
+    else
+      u = (unsigned long) LONG_MAX + 1;
+    if (u <= (unsigned long) LONG_MAX)
+    {
+      dest.SetValue((x.m_value < 0) ? -(long) u : (long) u);
+      return;
+    }
+  }
+  LongIntegerRep xb;
+  dest.rep = lshift(x.GetRep(xb), y, dest.rep);
+  dest.Normalize();
 }
 
 void  rshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, -y, dest.rep);
+  lshift(x, -y, dest);
 }
 
 void  pow(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = power(x.rep, y, dest.rep);
+  LongIntegerRep xb;
+  dest.rep = power(x.GetRep(xb), y, dest.rep);
+  dest.Normalize();
 }
 
 void abs(const Integer& x, Integer& dest)
 {
-  dest.rep = abs(x.rep, dest.rep);
+  if (x.rep == 0 && x.m_value != LONG_MIN)
+  {
+    dest.SetValue((x.m_value < 0) ? -x.m_value : x.m_value);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = abs(x.GetRep(xb), dest.rep);
+  dest.Normalize();
 }
 
 void negate(const Integer& x, Integer& dest)
 {
-  dest.rep = negate(x.rep, dest.rep);
+  if (x.rep == 0 && x.m_value != LONG_MIN)
+  {
+    dest.SetValue(-x.m_value);
+    return;
+  }
+  LongIntegerRep xb;
+  dest.rep = negate(x.GetRep(xb), dest.rep);
+  dest.Normalize();
 }
 
 void complement(const Integer& x, Integer& dest)
 {
-  dest.rep = Compl(x.rep, dest.rep);
+  LongIntegerRep xb;
+  dest.rep = Compl(x.GetRep(xb), dest.rep);
+  dest.Normalize();
 }
 
 void  add(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 0, x, dest.rep);
+  add(y, x, dest);
 }
 
 void  sub(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 1, x, dest.rep);
+  long r;
+  if (y.rep == 0 && sub_long(x, y.m_value, r))
+  {
+    dest.SetValue(r);
+    return;
+  }
+  LongIntegerRep yb;
+  dest.rep = add(y.GetRep(yb), 1, x, dest.rep);
+  dest.Normalize();
 }
 
 void  mul(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(y.rep, x, dest.rep);
+  mul(y, x, dest);
 }
 
 // operator versions
@@ -2698,28 +2938,37 @@ void Integer::negate()
 
 int sign(const Integer& x)
 {
+  if (x.rep == 0)
+    return (x.m_value > 0) - (x.m_value < 0);
   return (x.rep->len == 0) ? 0 : ( (x.rep->sgn == 1) ? 1 : -1 );
 }
 
 int even(const Integer& y)
 {
+  if (y.rep == 0)
+    return !(y.m_value & 1);
   return y.rep->len == 0 || !(y.rep->s[0] & 1);
 }
 
 int odd(const Integer& y)
 {
+  if (y.rep == 0)
+    return (y.m_value & 1) != 0;
   return y.rep->len > 0 && (y.rep->s[0] & 1);
 }
 
 std::string Itoa(const Integer& y, int base, int width)
 {
-  return Itoa(y.rep, base, width);
+  LongIntegerRep yb;
+  return Itoa(y.GetRep(yb), base, width);
 }
 
 
 
 long lg(const Integer& x) 
 {
+  if (x.rep == 0)
+    return lg(uabs(x.m_value));
   return lg(x.rep);
 }
 
@@ -2872,13 +3121,28 @@ Integer  atoI(const char* s, int base)
 {
   Integer r;
   r.rep = atoIntegerRep(s, base);
+  r.Normalize();
   return r;
 }
 
 Integer  gcd(const Integer& x, const Integer& y)
 {
+  if (x.rep == 0 && y.rep == 0)
+  {
+    unsigned long u = uabs(x.m_value), v = uabs(y.m_value);
+    while (v != 0)
+    {
+      unsigned long t = u % v;
+      u = v;
+      v = t;
+    }
+    if (u <= (unsigned long) LONG_MAX)
+      return Integer((long) u);
+  }
+  LongIntegerRep xb, yb;
   Integer r;
-  r.rep = gcd(x.rep, y.rep);
+  r.rep = gcd(x.GetRep(xb), y.GetRep(yb));
+  r.Normalize();
   return r;
 }
 
@@ -28,23 +28,41 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #ifndef LIBGAMBIT_INTEGER_H
 #define LIBGAMBIT_INTEGER_H
 
+#include <climits>
 #include <string>
 
 namespace Gambit {
 
+// A single digit of an IntegerRep.  Digits are half as wide as an
+// unsigned long, so that the product of two digits plus a carry
+// fits exactly in an unsigned long.
+#if ULONG_MAX > 0xffffffffUL
+typedef unsigned int IntegerDigit;
+#else
+typedef unsigned short IntegerDigit;
+#endif
+
 struct IntegerRep                    // internal Integer representations
 {
   unsigned short  len;          // current length
   unsigned short  sz;           // allocated space (0 means static).
   short           sgn;          // 1 means >= 0; 0 means < 0 
-  unsigned short  s[1];         // represented as ushort array starting here
+  IntegerDigit    s[1];         // represented as digit array starting here
+};
+
+// An IntegerRep with room for the digits of any long.  Used to present
+// a value held inline in an Integer to the IntegerRep routines.
+struct LongIntegerRep
+{
+  IntegerRep      rep;
+  IntegerDigit    more[sizeof(long) / sizeof(IntegerDigit)];
 };
 
 // True if REP is staticly (or manually) allocated,
 // and should not be deleted by an Integer destructor.
 #define STATIC_IntegerRep(rep) ((rep)->sz==0)
 
-extern IntegerRep*  Ialloc(IntegerRep*, const unsigned short *, int, int, int);
+extern IntegerRep*  Ialloc(IntegerRep*, const IntegerDigit *, int, int, int);
 extern IntegerRep*  Icalloc(IntegerRep*, int);
 extern IntegerRep*  Icopy_ulong(IntegerRep*, unsigned long);
 extern IntegerRep*  Icopy_long(IntegerRep*, long);
@@ -82,9 +100,24 @@ extern int      Iislong(const IntegerRep*);
 extern int      Iisdouble(const IntegerRep*);
 extern long     lg(const IntegerRep*);
 
+//
+// An arbitrary-length integer.  Values which fit in a long are held
+// inline, without allocation, and arithmetic on them is done directly
+// in machine words; an IntegerRep is allocated only when a result
+// overflows a long.  An Integer whose value fits in a long is always
+// held inline.
+//
 class Integer {
 protected:
-  IntegerRep *rep;
+  IntegerRep *rep;      // digits of the value, or null if held inline
+  long m_value;         // the value, if rep is null
+
+  /// Returns the value as an IntegerRep, using buf if held inline
+  const IntegerRep *GetRep(LongIntegerRep &buf) const;
+  /// Sets the value to y, releasing any allocated digits
+  void SetValue(long y);
+  /// Moves the value inline if it fits in a long
+  void Normalize(void);
 
 public:
   /// @name Lifecycle
@@ -218,11 +251,13 @@ public:
 
   // coercion & conversion
 
-  int             fits_in_long() const { return Iislong(rep); }
-  int             fits_in_double() const { return Iisdouble(rep); }
+  int             fits_in_long() const { return rep == 0; }
+  int             fits_in_double() const 
+    { return rep == 0 || Iisdouble(rep); }
 
-  long		  as_long() const { return Itolong(rep); }
-  double	  as_double() const { return Itodouble(rep); }
+  long		  as_long() const 
+    { return (rep == 0) ? m_value : Itolong(rep); }
+  double	  as_double() const;
 
   friend std::string    Itoa(const Integer& x, int base = 10, int width = 0);
   friend Integer  atoI(const char* s, int base = 10);
@@ -238,6 +273,52 @@ public:
 };
 
 
+//
+// Arithmetic on longs with overflow detection.  Each forms the result
+// in r and returns true, or returns false if it does not fit in a long.
+//
+
+inline unsigned long uabs(long x)
+{
+  return (x >= 0) ? (unsigned long) x : -(unsigned long) x;
+}
+
+inline bool add_long(long x, long y, long &r)
+{
+  if ((y >= 0) ? (x > LONG_MAX - y) : (x < LONG_MIN - y))
+    return false;
+  r = x + y;
+  return true;
+}
+
+inline bool sub_long(long x, long y, long &r)
+{
+  if ((y >= 0) ? (x < LONG_MIN + y) : (x > LONG_MAX + y))
+    return false;
+  r = x - y;
+  return true;
+}
+
+inline bool mul_long(long x, long y, long &r)
+{
+  // below this magnitude, products cannot overflow
+  const long half = 1L << (sizeof(long) * CHAR_BIT / 2 - 1);
+  if (x > -half && x < half && y > -half && y < half)
+  {
+    r = x * y;
+    return true;
+  }
+  if (x == 0 || y == 0)
+  {
+    r = 0;
+    return true;
+  }
+  if (x == LONG_MIN || y == LONG_MIN || uabs(x) > LONG_MAX / uabs(y))
+    return false;
+  r = x * y;
+  return true;
+}
+
 //  (These are declared inline)
 
 Integer  abs(const Integer&); // absolute value
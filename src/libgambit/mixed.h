@@ -24,10 +24,13 @@
 #define LIBGAMBIT_MIXED_H
 
 #include "vector.h"
+#include "matrix.h"
 #include "gameagg.h"
 
 namespace Gambit {
 
+class GameTreeNodeRep;
+
 template <class T> class MixedStrategyProfileRep {
 public:
   Vector<T> m_probs;
@@ -48,10 +51,35 @@ public:
   virtual T GetPayoff(int pl) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
+  /// Computes the payoff to each of player pl's strategies in the support
+  virtual void GetPayoffVector(int pl, Vector<T> &) const;
+  /// Computes the second derivatives of player pl's payoff with respect
+  /// to pairs of strategies of pl and of the other players
+  virtual void GetPayoffDerivs(int pl, Matrix<T> &) const;
 };
 
 template <class T> class TreeMixedStrategyProfileRep 
   : public MixedStrategyProfileRep<T> {
+private:
+  /// @name Private payoff computation
+  //@{
+  /// \brief Accumulates payoffs by the player's last action on the path
+  ///
+  /// Accumulates the payoffs to player pl in the subtree rooted at
+  /// p_node, weighted by the probabilities of the other players' and
+  /// chance's actions, into p_values according to the last action of
+  /// player pl on the path to each node (or p_rootValue, if none).
+  /// Returns false if some information set of player pl can be reached
+  /// after different last actions of player pl, that is, if the player
+  /// does not have perfect recall.
+  bool AccumulatePayoffs(int pl, GameTreeNodeRep *p_node,
+			 const MixedBehavProfile<T> &p_behav, const T &p_prob,
+			 int p_iset, int p_action, T &p_rootValue,
+			 Array<Array<T> > &p_values,
+			 Array<int> &p_priorIsets,
+			 Array<int> &p_priorActions) const;
+  //@}
+
 public:
   TreeMixedStrategyProfileRep(const StrategySupport &p_support)
     : MixedStrategyProfileRep<T>(p_support)
@@ -63,33 +91,79 @@ public:
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetPayoffVector(int pl, Vector<T> &) const;
 };
 
 template <class T> class TableMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
 private:
-  /// @name Private recursive payoff functions
+  /// Scratch space for partially contracted payoff tables
+  mutable Array<T> m_scratch, m_slabScratch;
+
+  /// @name Private payoff computation
   //@{
-  /// Recursive computation of payoff to player pl
-  T GetPayoff(int pl, int index, int i) const;
-  /// Recursive computation of payoff derivative
-  void GetPayoffDeriv(int pl, int const_pl, int cur_pl, long index,
-		      const T &prob, T &value) const;
-  /// Recursive computation of payoff second derivative
-  void GetPayoffDeriv(int pl, int const_pl1, int const_pl2, 
-		      int cur_pl, long index, const T &prob, T &value) const;
+  /// Largest offset of the player's strategies included in a contraction,
+  /// or -1 if none are included
+  long MaxOffset(int p, bool p_positive) const;
+  /// \brief Contracts the axes of a range of players
+  ///
+  /// Contracts the axes of players p_last down to p_first of the
+  /// partially contracted table p_in, skipping the players of the fixed
+  /// strategies.  p_extent is the number of entries of p_in still in use.
+  /// Returns a pointer to the result, which lies in p_scratch unless no
+  /// axis was contracted, in which case it is p_in itself.
+  const T *ContractAxes(const T *p_in, long p_extent, 
+			int p_first, int p_last,
+			const GameStrategyRep *p_fixed1,
+			const GameStrategyRep *p_fixed2,
+			bool p_positive, Array<T> &p_scratch) const;
+  /// \brief Contracts player pl's payoff table against the profile
+  ///
+  /// Computes the expected payoff to player pl, with the strategies of
+  /// up to two players held fixed (either strategy may be null).
+  /// The table is contracted along one player's axis at a time,
+  /// starting from the player with the largest stride.  If p_positive
+  /// is true, only strategies with positive probability are included;
+  /// otherwise, all strategies with nonzero probability are.
+  T Contract(int pl, const GameStrategyRep *p_fixed1,
+	     const GameStrategyRep *p_fixed2, bool p_positive) const;
+  //@}
+
+  /// @name Private payoff computation for sparse storage
+  /// These visit only the contingencies with outcomes, in the order
+  /// given by GameTableRep::GetSparseOffsets().
+  //@{
+  /// \brief Returns the probabilities of the strategies of each player
+  ///
+  /// The probabilities are indexed by player and strategy number, and
+  /// are zero for strategies not in the support.  The strides are those
+  /// of each player's axis in the offsets of contingencies.
+  void GetSparseAxes(Array<long> &p_strides, Array<Array<T> > &p_probs) const;
+  /// As Contract(), for games in sparse storage
+  T SparseContract(int pl, const GameStrategyRep *p_fixed1,
+		   const GameStrategyRep *p_fixed2) const;
+  /// As GetPayoffVector(), for games in sparse storage
+  void SparsePayoffVector(int pl, Vector<T> &) const;
+  /// As GetPayoffDerivs(), for games in sparse storage
+  void SparsePayoffDerivs(int pl, Matrix<T> &) const;
   //@}
 
 public:
   TableMixedStrategyProfileRep(const StrategySupport &p_support)
     : MixedStrategyProfileRep<T>(p_support)
   { }
+  /// Copy constructor; the scratch space is not copied
+  TableMixedStrategyProfileRep(const TableMixedStrategyProfileRep<T> &p_profile)
+    : MixedStrategyProfileRep<T>(p_profile)
+  { }
   virtual ~TableMixedStrategyProfileRep() { }
 
   virtual MixedStrategyProfileRep<T> *Copy(void) const;
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetPayoffVector(int pl, Vector<T> &) const;
+  virtual void GetPayoffDerivs(int pl, Matrix<T> &) const;
 };
 
 template <class T> class AggMixedStrategyProfileRep
@@ -107,6 +181,7 @@ public:
     virtual T GetPayoff(int pl) const;
     virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
     virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+    virtual void GetPayoffVector(int pl, Vector<T> &) const;
 };
 
 /// \brief A probability distribution over strategies in a game
@@ -214,6 +289,32 @@ public:
   T GetPayoff(const GameStrategy &p_strategy) const
   { return GetPayoffDeriv(p_strategy->GetPlayer()->GetNumber(), p_strategy); }
 
+  /// \brief Computes the payoffs to all of a player's strategies
+  ///
+  /// Computes the payoff to playing each of player pl's strategies in
+  /// the support against the profile, indexed by the strategies' indices
+  /// in the support.  This gives the same values as calling GetPayoff()
+  /// on each strategy, but in a single pass over the game for most
+  /// representations.  The vector must have one entry per strategy.
+  void GetPayoffVector(int pl, Vector<T> &p_values) const;
+
+  /// \brief Computes the payoffs to all strategies of all players
+  ///
+  /// Computes the payoff to playing each strategy in the support against
+  /// the profile, indexed in the same way as the profile itself.
+  void GetPayoffVector(Vector<T> &p_values) const;
+
+  /// \brief Computes the second derivatives of a player's payoff
+  ///
+  /// Computes the derivatives of player pl's payoff with respect to pairs
+  /// of strategies, one of player pl and one of another player.  Entry
+  /// (j, k) is GetPayoffDeriv(pl, s, t), where s is player pl's j'th
+  /// strategy in the support and t is the strategy at index k of the
+  /// profile; the columns of player pl's own strategies are zero.  The
+  /// matrix must have one row per strategy of pl in the support, and
+  /// one column per entry of the profile.
+  void GetPayoffDerivs(int pl, Matrix<T> &p_derivs) const;
+
   /// \brief Computes the Lyapunov value of the profile
   ///
   /// Computes the Lyapunov value of the profile.  This is a nonnegative
@@ -0,0 +1,278 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/number.cc
+// Implementation of compact storage of numerical data in a game
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cctype>
+#include <climits>
+
+#include "libgambit.h"
+
+namespace Gambit {
+
+//========================================================================
+//                          class Number
+//========================================================================
+
+//------------------------------------------------------------------------
+//                      Number: Lifecycle
+//------------------------------------------------------------------------
+
+Number::Number(const Number &p_number)
+  : m_double(p_number.m_double), 
+    m_num(p_number.m_num), m_den(p_number.m_den),
+    m_decimals(p_number.m_decimals),
+    m_rational((p_number.m_den == 0) ? 
+	       new Rational(*p_number.m_rational) : 0),
+    m_text((p_number.m_text) ? new std::string(*p_number.m_text) : 0)
+{ }
+
+Number::~Number()
+{
+  delete m_rational;
+  delete m_text;
+}
+
+Number &Number::operator=(const Number &p_number)
+{
+  if (this != &p_number) {
+    delete m_rational;
+    delete m_text;
+    m_double = p_number.m_double;
+    m_num = p_number.m_num;
+    m_den = p_number.m_den;
+    m_decimals = p_number.m_decimals;
+    m_rational = (p_number.m_den == 0) ? 
+      new Rational(*p_number.m_rational) : 0;
+    m_text = (p_number.m_text) ? new std::string(*p_number.m_text) : 0;
+  }
+  return *this;
+}
+
+//------------------------------------------------------------------------
+//                   Number: Compact representation
+//------------------------------------------------------------------------
+
+bool Number::GetCompact(int &p_num, int &p_den, int &p_decimals) const
+{
+  if (m_den == 0 || (m_text && *m_text != GenerateText())) {
+    return false;
+  }
+  p_num = m_num;
+  p_den = m_den;
+  p_decimals = m_decimals;
+  return true;
+}
+
+void Number::SetCompact(double p_double, int p_num, int p_den, int p_decimals)
+{
+  delete m_rational;
+  delete m_text;
+  m_rational = 0;
+  m_text = 0;
+  m_double = p_double;
+  m_num = p_num;
+  m_den = p_den;
+  m_decimals = p_decimals;
+}
+
+//------------------------------------------------------------------------
+//                 Number: Private auxiliary functions
+//------------------------------------------------------------------------
+
+namespace {
+
+//
+// Parses the digits at p_text into p_value, which must fit in an int,
+// and advances p_text past them.  Returns the number of digits.
+//
+int ParseDigits(const char *&p_text, int &p_value)
+{
+  int digits = 0;
+  for (; isdigit(*p_text); p_text++) {
+    if (++digits > 9)  return 10;
+    p_value = 10 * p_value + (*p_text - '0');
+  }
+  return digits;
+}
+
+int GCD(int a, int b)
+{
+  while (b != 0) {
+    int r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+//
+// Parses text consisting of an optional minus sign and an integer, a
+// decimal with at least one digit after the point, or a fraction in
+// lowest terms, written as Number would generate it.  The digits must
+// fit in an int.  Returns false if the text is not of this form.
+//
+bool ParseSimpleText(const std::string &p_text, 
+		     int &p_num, int &p_den, int &p_decimals)
+{
+  const char *c = p_text.c_str();
+  bool negative = (*c == '-');
+  if (negative)  c++;
+  // Leading zeros are not generated
+  if (c[0] == '0' && isdigit(c[1]))  return false;
+
+  int num = 0, den = 1, decimals = -1;
+  int digits = ParseDigits(c, num);
+  if (digits == 0 || digits > 9)  return false;
+
+  if (*c == '.') {
+    c++;
+    int fraction = 0;
+    decimals = ParseDigits(c, fraction);
+    if (decimals == 0 || digits + decimals > 9)  return false;
+    for (int i = 0; i < decimals; i++) {
+      num *= 10;
+      den *= 10;
+    }
+    num += fraction;
+  }
+  else if (*c == '/') {
+    c++;
+    den = 0;
+    if (*c == '0' || ParseDigits(c, den) > 9 || den <= 1 || 
+	GCD(num, den) != 1)  return false;
+  }
+  if (*c != '\0' || (negative && num == 0))  return false;
+
+  int divisor = GCD(num, den);
+  p_num = (negative) ? -num / divisor : num / divisor;
+  p_den = den / divisor;
+  p_decimals = decimals;
+  return true;
+}
+
+}  // end anonymous namespace
+
+void Number::SetText(const std::string &p_text)
+{
+  // Integers and decimals of a few digits, such as payoffs in most game
+  // files, are converted without going through Rational
+  int simpleNum, simpleDen, simpleDecimals;
+  if (ParseSimpleText(p_text, simpleNum, simpleDen, simpleDecimals)) {
+    delete m_rational;
+    delete m_text;
+    m_rational = 0;
+    m_text = 0;
+    m_num = simpleNum;
+    m_den = simpleDen;
+    m_decimals = simpleDecimals;
+    m_double = (m_den == 1) ? (double) m_num : (double) Rational(m_num, m_den);
+    return;
+  }
+
+  // We call lexical_cast<Rational>() first because it throws a ValueException
+  // if the conversion of the text fails
+  Rational value = lexical_cast<Rational>(p_text);
+
+  delete m_rational;
+  delete m_text;
+  m_rational = 0;
+  m_text = 0;
+
+  m_double = (double) value;
+  const Integer &num = value.numerator(), &den = value.denominator();
+  if (num.fits_in_long() && num.as_long() >= INT_MIN && 
+      num.as_long() <= INT_MAX &&
+      den.fits_in_long() && den.as_long() <= INT_MAX) {
+    m_num = (int) num.as_long();
+    m_den = (int) den.as_long();
+  }
+  else {
+    m_num = 0;
+    m_den = 0;
+    m_rational = new Rational(value);
+  }
+
+  std::string::size_type point = p_text.find('.');
+  m_decimals = (point == std::string::npos) ? -1 : 
+    (int) (p_text.length() - point - 1);
+
+  if (GenerateText() != p_text) {
+    m_text = new std::string(p_text);
+  }
+}
+
+//
+// The text is written as an integer or fraction, as Rational does, or
+// as a decimal with the same number of digits after the point as the
+// text entered.
+//
+std::string Number::GenerateText(void) const
+{
+  Integer num = (m_den == 0) ? m_rational->numerator() : Integer(m_num);
+  Integer den = (m_den == 0) ? m_rational->denominator() : Integer(m_den);
+
+  if (m_decimals < 0) {
+    if (den == 1) {
+      return Itoa(num);
+    }
+    return Itoa(num) + "/" + Itoa(den);
+  }
+
+  Integer scale(1);
+  for (int i = 0; i < m_decimals; i++) {
+    scale *= 10;
+  }
+  Integer scaled = num * scale;
+  if (scaled % den != 0) {
+    // Not a terminating decimal; this cannot happen for parsed text
+    return Itoa(num) + "/" + Itoa(den);
+  }
+  scaled /= den;
+
+  bool negative = (scaled < 0);
+  if (negative) {
+    scaled.negate();
+  }
+  std::string digits = Itoa(scaled);
+  if (digits.length() <= (std::string::size_type) m_decimals) {
+    digits.insert(0, m_decimals + 1 - digits.length(), '0');
+  }
+  digits.insert(digits.length() - m_decimals, ".");
+  return (negative) ? "-" + digits : digits;
+}
+
+const Rational &Number::GetRational(void) const
+{
+  if (!m_rational) {
+    m_rational = new Rational(m_num, m_den);
+  }
+  return *m_rational;
+}
+
+const std::string &Number::GetText(void) const
+{
+  if (!m_text) {
+    m_text = new std::string(GenerateText());
+  }
+  return *m_text;
+}
+
+}  // end namespace Gambit
@@ -25,34 +25,76 @@
 
 namespace Gambit {
 
-/// This simple class stores a numerical datum.
+/// \brief A numerical datum in a game, such as a payoff or probability
+///
+/// A number is entered as text, and is available as text, as an exact
+/// rational, and as a floating-point value.  Games may have very many
+/// of these, so only the floating-point value is always stored.  The
+/// exact value is kept inline when its numerator and denominator fit
+/// in an int, and is only built as a Rational when asked for.  The
+/// text is regenerated from the exact value when asked for, and is only
+/// kept if it was entered in a form which cannot be regenerated, for
+/// instance with a leading plus sign or an exponent.
 class Number {
 private:
-  std::string m_text;
-  Rational m_rational;
   double m_double;
+  /// The numerator and denominator of the value, if these fit in an int;
+  /// otherwise, the denominator is zero, and m_rational holds the value
+  int m_num, m_den;
+  /// The number of digits after the decimal point in the text, or -1
+  /// if the text is an integer or a fraction
+  int m_decimals;
+  /// The exact value, if it does not fit inline or has been asked for
+  mutable Rational *m_rational;
+  /// The text, if it cannot be regenerated or has been asked for
+  mutable std::string *m_text;
+
+  /// @name Private auxiliary functions
+  //@{
+  void SetText(const std::string &);
+  std::string GenerateText(void) const;
+  const Rational &GetRational(void) const;
+  const std::string &GetText(void) const;
+  //@}
 
 public:
+  /// @name Lifecycle
+  //@{
   Number(void)
-    : m_text("0"), m_rational(0), m_double(0.0) { }
+    : m_double(0.0), m_num(0), m_den(1), m_decimals(-1),
+      m_rational(0), m_text(0) { }
   Number(const std::string &p_text)
-    : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
-      m_double((double) m_rational)
-  { }
+    : m_rational(0), m_text(0)
+  { SetText(p_text); }
+  Number(const Number &);
+  ~Number();
   
+  Number &operator=(const Number &);
   Number &operator=(const std::string &p_text)
-  {
-    // We call lexical_cast<Rational>() first because it throws a ValueException
-    // if the conversion of the text fails
-    m_rational = lexical_cast<Rational>(p_text);
-    m_text = p_text;
-    m_double = (double) m_rational;
-    return *this; 
-  }
+  { SetText(p_text); return *this; }
+  //@}
+
+  /// Generates the exact value and the text now, so that later
+  /// conversions only read the object
+  void Materialize(void) const { GetRational().numerator();  GetText(); }
+
+  /// @name Compact representation
+  /// A number whose value is a fraction of ints, and whose text is as
+  /// it would be generated from its value, is given fully by its value
+  /// and the number of digits after the decimal point (-1 if there is
+  /// no decimal point).  This is used to store numbers in binary files.
+  //@{
+  /// Returns true if the number has a compact representation, and if so
+  /// sets the arguments to it
+  bool GetCompact(int &p_num, int &p_den, int &p_decimals) const;
+  /// Sets the number from its compact representation, with p_num and
+  /// p_den in lowest terms, and its value as a double
+  void SetCompact(double p_double, int p_num, int p_den, int p_decimals);
+  //@}
 
   operator const double &(void) const { return m_double; }
-  operator const Rational &(void) const { return m_rational; }
-  operator const std::string &(void) const { return m_text; }
+  operator const Rational &(void) const { return GetRational(); }
+  operator const std::string &(void) const { return GetText(); }
 };
 
 }
@@ -38,6 +38,54 @@ namespace Gambit {
 
 static const Integer _Int_One(1);
 
+// Results of arithmetic in longs are left unreduced while the numerator
+// and denominator are below this magnitude, so that products of two
+// of them cannot overflow.
+static const long RATIONAL_REDUCE = 1L << (sizeof(long) * CHAR_BIT / 2 - 1);
+
+static unsigned long gcd_long(unsigned long u, unsigned long v)
+{
+  while (v != 0) {
+    unsigned long t = u % v;
+    u = v;
+    v = t;
+  }
+  return u;
+}
+
+// Fetches the numerator and denominator as longs, if they fit
+inline static bool as_longs(const Integer &num, const Integer &den,
+			    long &n, long &d)
+{
+  if (!num.fits_in_long() || !den.fits_in_long()) {
+    return false;
+  }
+  n = num.as_long();
+  d = den.as_long();
+  return true;
+}
+
+void Rational::reduce(void) const
+{
+  long n, d;
+  if (as_longs(num, den, n, d) && d != 1) {
+    long g = (long) gcd_long(uabs(n), (unsigned long) d);
+    if (g > 1) {
+      num = n / g;
+      den = d / g;
+    }
+  }
+}
+
+void Rational::assign(long n, long d)
+{
+  num = n;
+  den = d;
+  if (uabs(n) >= (unsigned long) RATIONAL_REDUCE || d >= RATIONAL_REDUCE) {
+    reduce();
+  }
+}
+
 void Rational::normalize(void)
 {
   int s = sign(den);
@@ -49,6 +97,11 @@ void Rational::normalize(void)
     num.negate();
   }
 
+  if (num.fits_in_long() && den.fits_in_long()) {
+    reduce();
+    return;
+  }
+
   Integer g = gcd(num, den);
   if (ucompare(g, _Int_One) != 0)  {
     num /= g;
@@ -58,6 +111,24 @@ void Rational::normalize(void)
 
 void      add(const Rational& x, const Rational& y, Rational& r)
 {
+  long a, b, c, d, n, m;
+  if (as_longs(x.num, x.den, a, b) && as_longs(y.num, y.den, c, d)) {
+    if (b == d) {
+      if (add_long(a, c, n)) {
+	r.assign(n, b);
+	return;
+      }
+    }
+    else {
+      long p, q;
+      if (mul_long(a, d, p) && mul_long(c, b, q) && 
+	  add_long(p, q, n) && mul_long(b, d, m)) {
+	r.assign(n, m);
+	return;
+      }
+    }
+  }
+
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -78,6 +149,24 @@ void      add(const Rational& x, const Rational& y, Rational& r)
 
 void      sub(const Rational& x, const Rational& y, Rational& r)
 {
+  long a, b, c, d, n, m;
+  if (as_longs(x.num, x.den, a, b) && as_longs(y.num, y.den, c, d)) {
+    if (b == d) {
+      if (sub_long(a, c, n)) {
+	r.assign(n, b);
+	return;
+      }
+    }
+    else {
+      long p, q;
+      if (mul_long(a, d, p) && mul_long(c, b, q) && 
+	  sub_long(p, q, n) && mul_long(b, d, m)) {
+	r.assign(n, m);
+	return;
+      }
+    }
+  }
+
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -98,6 +187,13 @@ void      sub(const Rational& x, const Rational& y, Rational& r)
 
 void      mul(const Rational& x, const Rational& y, Rational& r)
 {
+  long a, b, c, d, n, m;
+  if (as_longs(x.num, x.den, a, b) && as_longs(y.num, y.den, c, d) &&
+      mul_long(a, c, n) && mul_long(b, d, m)) {
+    r.assign(n, m);
+    return;
+  }
+
   mul(x.num, y.num, r.num);
   mul(x.den, y.den, r.den);
   r.normalize();
@@ -105,6 +201,23 @@ void      mul(const Rational& x, const Rational& y, Rational& r)
 
 void      div(const Rational& x, const Rational& y, Rational& r)
 {
+  long a, b, c, d, n, m;
+  if (as_longs(x.num, x.den, a, b) && as_longs(y.num, y.den, c, d)) {
+    if (c == 0) {
+      throw ZeroDivideException();
+    }
+    if (mul_long(a, d, n) && mul_long(b, c, m) && 
+	n != LONG_MIN && m != LONG_MIN) {
+      if (m < 0) {
+	r.assign(-n, -m);
+      }
+      else {
+	r.assign(n, m);
+      }
+      return;
+    }
+  }
+
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -143,7 +256,14 @@ int compare(const Rational& x, const Rational& y)
   int xsgn = sign(x.num);
   int ysgn = sign(y.num);
   int d = xsgn - ysgn;
-  if (d == 0 && xsgn != 0) d = compare(x.num * y.den, x.den * y.num);
+  if (d == 0 && xsgn != 0) {
+    long a, b, c, e, p, q;
+    if (as_longs(x.num, x.den, a, b) && as_longs(y.num, y.den, c, e) &&
+	mul_long(a, e, p) && mul_long(b, c, q)) {
+      return (p < q) ? -1 : (p > q);
+    }
+    d = compare(x.num * y.den, x.den * y.num);
+  }
   return d;
 }
 
@@ -255,6 +375,7 @@ Integer round(const Rational& x)
 
 Rational pow(const Rational& x, long y)
 {
+  x.reduce();
   Rational r;
   if (y >= 0)
     {
@@ -364,6 +485,7 @@ std::istream &operator>>(std::istream &f, Rational &y)
 
 bool Rational::OK(void) const
 {
+  reduce();
   int v = num.OK() && den.OK(); // have valid num and denom
   if (v)   {
     v &= sign(den) > 0;           // denominator positive;
@@ -390,15 +512,12 @@ Rational::fits_in_double() const
 // These were moved from the header file to eliminate warnings
 //
 
-static IntegerRep _ZeroRep = {1, 0, 1, {0}};
-static IntegerRep _OneRep = {1, 0, 1, {1}};
-
-Rational::Rational() : num(&_ZeroRep), den(&_OneRep) {}
+Rational::Rational() : num(0), den(1) {}
 Rational::~Rational() {}
 
 Rational::Rational(const Rational& y) :num(y.num), den(y.den) {}
 
-Rational::Rational(const Integer& n) :num(n), den(&_OneRep) {}
+Rational::Rational(const Integer& n) :num(n), den(1) {}
 
 Rational::Rational(const Integer& n, const Integer& d) 
  : num(n), den(d)
@@ -409,9 +528,9 @@ Rational::Rational(const Integer& n, const Integer& d)
   normalize();
 }
 
-Rational::Rational(long n) :num(n), den(&_OneRep) { }
+Rational::Rational(long n) :num(n), den(1) { }
 
-Rational::Rational(int n) :num(n), den(&_OneRep) { }
+Rational::Rational(int n) :num(n), den(1) { }
 
 Rational::Rational(long n, long d) 
  : num(n), den(d)
@@ -438,12 +557,19 @@ Rational &Rational::operator =  (const Rational& y)
 
 bool Rational::operator==(const Rational &y) const
 {
+  long a, b, c, d, p, q;
+  if (as_longs(num, den, a, b) && as_longs(y.num, y.den, c, d) &&
+      mul_long(a, d, p) && mul_long(b, c, q)) {
+    return p == q;
+  }
+  reduce();
+  y.reduce();
   return compare(num, y.num) == 0 && compare(den, y.den) == 0;
 }
 
 bool Rational::operator!=(const Rational &y) const
 {
-  return compare(num, y.num) != 0 || compare(den, y.den) != 0;
+  return !(*this == y);
 }
 
 bool Rational::operator< (const Rational &y) const
@@ -501,15 +627,15 @@ Rational &Rational::operator/=(const Rational& y)
   return *this;
 }
 
-const Integer& Rational::numerator() const { return num; }
-const Integer& Rational::denominator() const { return den; }
+const Integer& Rational::numerator() const { reduce(); return num; }
+const Integer& Rational::denominator() const { reduce(); return den; }
 
 Rational::operator double(void) const 
 {
   // We approach this in terms of absolute values because there is
   // (apparently) a bug in ratio() which yields incorrect results
   // for some negative numbers (TLT, 27 Feb 2006).
-  Integer x(num), y(den);
+  Integer x(numerator()), y(denominator());
   x.abs();
   y.abs();
   
@@ -34,11 +34,22 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 namespace Gambit {
 
 /// A representation of an arbitrary-precision rational number
+///
+/// Arithmetic on values whose numerators and denominators fit in a long
+/// is done directly in longs, and the result is not reduced to lowest
+/// terms until it grows large, or until the numerator or denominator is
+/// asked for.  A value whose numerator or denominator does not fit in
+/// a long is always kept in lowest terms.
 class Rational {
 protected:
-  Integer num, den;
+  mutable Integer num, den;
 
   void normalize();
+  /// Divides out any common factor of a numerator and denominator
+  /// which fit in a long; does not change the value
+  void reduce() const;
+  /// Sets the value to n/d, with d > 0, reducing if either is large
+  void assign(long n, long d);
 
 public:
   Rational(void);
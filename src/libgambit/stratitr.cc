@@ -32,21 +32,27 @@ namespace Gambit {
 //                               Lifecycle
 //---------------------------------------------------------------------------
 
-StrategyIterator::StrategyIterator(const StrategySupport &p_support)
-  : m_atEnd(false), m_support(p_support),
+StrategyIterator::StrategyIterator(const StrategySupport &p_support,
+				   bool p_grayCode /* = false */)
+  : m_atEnd(false), m_grayCode(p_grayCode), m_support(p_support),
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_direction(m_support.GetGame()->NumPlayers()),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
-    m_frozen1(0), m_frozen2(0)
+    m_frozen1(0), m_frozen2(0),
+    m_stride(m_support.GetGame()->NumPlayers())
 {
   First();
 }
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support,
-				   int pl, int st)
-  : m_atEnd(false), m_support(p_support), 
+				   int pl, int st,
+				   bool p_grayCode /* = false */)
+  : m_atEnd(false), m_grayCode(p_grayCode), m_support(p_support), 
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_direction(m_support.GetGame()->NumPlayers()),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
-    m_frozen1(pl), m_frozen2(0)
+    m_frozen1(pl), m_frozen2(0),
+    m_stride(m_support.GetGame()->NumPlayers())
 {
   m_currentStrat[pl] = st;
   m_profile->SetStrategy(m_support.GetStrategy(pl, st));
@@ -54,12 +60,15 @@ StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 }
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support,
-				   const GameStrategy &p_strategy)
-  : m_atEnd(false), m_support(p_support),
+				   const GameStrategy &p_strategy,
+				   bool p_grayCode /* = false */)
+  : m_atEnd(false), m_grayCode(p_grayCode), m_support(p_support),
     m_currentStrat(p_support.GetGame()->NumPlayers()),
+    m_direction(p_support.GetGame()->NumPlayers()),
     m_profile(p_support.GetGame()->NewPureStrategyProfile()), 
     m_frozen1(p_strategy->GetPlayer()->GetNumber()),
-    m_frozen2(0)
+    m_frozen2(0),
+    m_stride(p_support.GetGame()->NumPlayers())
 {
   m_currentStrat[m_frozen1] = p_strategy->GetNumber();
   m_profile->SetStrategy(p_strategy);
@@ -69,11 +78,14 @@ StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 				   int pl1, int st1,
-				   int pl2, int st2)
-  : m_atEnd(false), m_support(p_support), 
+				   int pl2, int st2,
+				   bool p_grayCode /* = false */)
+  : m_atEnd(false), m_grayCode(p_grayCode), m_support(p_support), 
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_direction(m_support.GetGame()->NumPlayers()),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
-    m_frozen1(pl1), m_frozen2(pl2)
+    m_frozen1(pl1), m_frozen2(pl2),
+    m_stride(m_support.GetGame()->NumPlayers())
 {
   m_currentStrat[pl1] = st1;
   m_profile->SetStrategy(m_support.GetStrategy(pl1, st1));
@@ -88,21 +100,52 @@ StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 
 void StrategyIterator::First(void)
 {
+  m_numContingencies = 1L;
   for (int pl = 1; pl <= m_support.GetGame()->NumPlayers(); pl++) {
-    if (pl == m_frozen1 || pl == m_frozen2) continue;
+    m_direction[pl] = 1;
+    if (pl == m_frozen1 || pl == m_frozen2) {
+      m_stride[pl] = 0L;
+      continue;
+    }
     m_profile->SetStrategy(m_support.GetStrategy(pl, 1));
     m_currentStrat[pl] = 1;
+    m_stride[pl] = m_numContingencies;
+    m_numContingencies *= m_support.NumStrategies(pl);
   }	
+  m_contingency = 1L;
+  m_changed = 0;
 }
 
 void StrategyIterator::operator++(void)
 {
+  int numPlayers = m_support.GetGame()->NumPlayers();
+
+  if (m_grayCode) {
+    // Advance the first player who is not at the end of the current
+    // sweep through the strategies; the sweeps of the players before
+    // are reversed
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      if (pl == m_frozen1 || pl == m_frozen2)  continue;
+      int st = m_currentStrat[pl] + m_direction[pl];
+      if (st >= 1 && st <= m_support.NumStrategies(pl)) {
+	m_currentStrat[pl] = st;
+	m_profile->SetStrategy(m_support.GetStrategy(pl, st));
+	m_contingency += m_direction[pl] * m_stride[pl];
+	m_changed = pl;
+	return;
+      }
+      m_direction[pl] = -m_direction[pl];
+    }
+    m_atEnd = true;
+    return;
+  }
+
   int pl = 1;
 
   while (1)   {
     if (pl == m_frozen1 || pl == m_frozen2) {
       pl++;
-      if (pl > m_support.GetGame()->NumPlayers()) {
+      if (pl > numPlayers) {
 	m_atEnd = true;
 	return;
       }
@@ -111,12 +154,15 @@ void StrategyIterator::operator++(void)
 
     if (m_currentStrat[pl] < m_support.NumStrategies(pl)) {
       m_profile->SetStrategy(m_support.GetStrategy(pl, ++(m_currentStrat[pl])));
+      m_contingency += m_stride[pl];
+      m_changed = pl;
       return;
     }
     m_profile->SetStrategy(m_support.GetStrategy(pl, 1));
+    m_contingency -= (m_currentStrat[pl] - 1) * m_stride[pl];
     m_currentStrat[pl] = 1;
     pl++;
-    if (pl > m_support.GetGame()->NumPlayers()) {
+    if (pl > numPlayers) {
       m_atEnd = true;
       return;
     }
@@ -32,15 +32,25 @@ namespace Gambit {
 /// on each call of NextContingency().  Optionally, the strategy of
 /// one player may be held fixed during the iteration (by the use of the
 /// second constructor).
+///
+/// By default, contingencies are visited in the order in which they are
+/// listed in a strategic game file, with the first player's strategy
+/// changing fastest.  In Gray-code order, successive contingencies
+/// instead differ in the strategy of exactly one player, so that
+/// quantities depending on the profile can be revised incrementally
+/// as the iteration proceeds.  In either order, GetContingency() gives
+/// the position of the current contingency in the default order.
 class StrategyIterator {
   friend class GameRep;
   friend class GameTableRep;
 private:
-  bool m_atEnd;
+  bool m_atEnd, m_grayCode;
   StrategySupport m_support;
-  Array<int> m_currentStrat;
+  Array<int> m_currentStrat, m_direction;
   PureStrategyProfile m_profile;
-  int m_frozen1, m_frozen2;
+  int m_frozen1, m_frozen2, m_changed;
+  long m_contingency, m_numContingencies;
+  Array<long> m_stride;
   
   /// Reset the iterator to the first contingency (this is called by ctors)
   void First(void);
@@ -49,14 +59,17 @@ public:
   /// @name Lifecycle
   //@{
   /// Construct a new iterator on the support, with no strategies held fixed
-  StrategyIterator(const StrategySupport &);
+  StrategyIterator(const StrategySupport &, bool p_grayCode = false);
   /// Construct a new iterator on the support, fixing player pl's strategy
-  StrategyIterator(const StrategySupport &s, int pl, int st);
+  StrategyIterator(const StrategySupport &s, int pl, int st,
+		   bool p_grayCode = false);
   /// Construct a new iterator on the support, fixing the given strategy
-  StrategyIterator(const StrategySupport &, const GameStrategy &);
+  StrategyIterator(const StrategySupport &, const GameStrategy &,
+		   bool p_grayCode = false);
   /// Construct a new iterator on the support, fixing two players' strategies
   StrategyIterator(const StrategySupport &s, 
-		   int pl1, int st1, int pl2, int st2);
+		   int pl1, int st1, int pl2, int st2,
+		   bool p_grayCode = false);
   //@}
 
   /// @name Iteration and data access
@@ -72,6 +85,16 @@ public:
   PureStrategyProfile &operator*(void) { return m_profile; }
   /// Get the current strategy profile
   const PureStrategyProfile &operator*(void) const { return m_profile; }
+
+  /// Returns the number of contingencies visited by the iterator
+  long NumContingencies(void) const { return m_numContingencies; }
+  /// Returns the position of the current contingency in the default
+  /// order, from 1 to NumContingencies()
+  long GetContingency(void) const { return m_contingency; }
+  /// Returns the player whose strategy was advanced on the last step,
+  /// or zero at the first contingency.  In Gray-code order, this is
+  /// the only player whose strategy changed.
+  int GetChangedPlayer(void) const { return m_changed; }
   //@}
 };
 
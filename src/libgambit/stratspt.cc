@@ -20,7 +20,9 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <vector>
 #include "libgambit.h"
+#include "gametable.h"
 
 namespace Gambit {
 
@@ -171,8 +173,10 @@ bool StrategySupport::Dominates(const GameStrategy &s,
 				bool p_strict) const
 {
   bool equal = true;
-  
-  for (StrategyIterator iter(*this); !iter.AtEnd(); iter++) {
+
+  // Strategy values do not depend on the player's own strategy, so only
+  // the contingencies of the other players need be visited
+  for (StrategyIterator iter(*this, s, true); !iter.AtEnd(); iter++) {
     Rational ap = (*iter)->GetStrategyValue(s);
     Rational bp = (*iter)->GetStrategyValue(t);
     if (p_strict && ap <= bp) {
@@ -214,82 +218,250 @@ bool StrategySupport::IsDominated(const GameStrategy &s,
   }
 }
 
-bool StrategySupport::Undominated(StrategySupport &newS, int p_player, 
-				  bool p_strict, bool p_external) const
+namespace {
+
+/// The payoffs to a player of each of a list of the player's strategies,
+/// against each contingency of the other players' strategies in a
+/// support.  The payoffs are extracted from the game once, and stored
+/// in doubles, one contiguous slice per strategy, so that dominance
+/// between strategies can be tested quickly, and from several threads.
+/// Where the doubles are not known to represent the payoffs exactly,
+/// comparisons within a tolerance are settled using the exact payoffs.
+class PayoffSlices {
+private:
+  int m_numStrategies, m_numContingencies;
+  std::vector<double> m_values;
+  bool m_exact;
+  double m_tolerance;
+
+  // For table games, exact payoffs are looked up in the game's table,
+  // using the index of each contingency and the offset of each strategy;
+  // for other games, they are stored along with the doubles
+  const Array<Rational> *m_table;
+  std::vector<long> m_index, m_offset;
+  std::vector<Rational> m_exactValues;
+
+  Rational GetExactValue(int p_strategy, int p_cont) const
+  { return (m_table) ? 
+      (*m_table)[m_index[p_cont] + m_offset[p_strategy - 1]] :
+      m_exactValues[(p_strategy - 1) * m_numContingencies + p_cont]; }
+
+public:
+  /// Outcomes of comparing two strategies in floating point
+  enum Comparison { DOMINATES, FAILS, UNDECIDED };
+
+  PayoffSlices(const StrategySupport &p_support, int p_player,
+	       const Array<GameStrategy> &p_strategies);
+
+  int NumStrategies(void) const { return m_numStrategies; }
+
+  Comparison Compare(int s, int t, bool p_strict) const;
+  bool Dominates(int s, int t, bool p_strict) const;
+};
+
+PayoffSlices::PayoffSlices(const StrategySupport &p_support, int p_player,
+			   const Array<GameStrategy> &p_strategies)
+  : m_numStrategies(p_strategies.Length()), m_numContingencies(0),
+    m_exact(true), m_tolerance(0.0), m_table(0)
 {
-  Array<GameStrategy> set((p_external) ? 
-			  m_nfg->GetPlayer(p_player)->NumStrategies() :
-			  NumStrategies(p_player));
+  Game game = p_support.GetGame();
+  for (StrategyIterator iter(p_support, p_player, 1); 
+       !iter.AtEnd(); iter++, m_numContingencies++);
+  m_values = std::vector<double>(m_numStrategies * m_numContingencies);
+
+  if (!game->IsTree() && !game->IsAgg()) {
+    GameTableRep &table = dynamic_cast<GameTableRep &>(*game);
+    m_table = &table.GetPayoffTable<Rational>(p_player);
+    const Array<double> &payoffs = table.GetPayoffTable<double>(p_player);
+
+    // The doubles are exact if all payoffs in the outcomes are
+    for (int outc = 1; m_exact && outc <= game->NumOutcomes(); outc++) {
+      GameOutcome outcome = game->GetOutcome(outc);
+      m_exact = (Rational(outcome->GetPayoff<double>(p_player)) ==
+		 outcome->GetPayoff<Rational>(p_player));
+    }
 
-  if (p_external) {
-    for (int st = 1; st <= set.Length(); st++) {
-      set[st] = m_nfg->GetPlayer(p_player)->GetStrategy(st);
+    m_index = std::vector<long>(m_numContingencies);
+    m_offset = std::vector<long>(m_numStrategies);
+    StrategyIterator iter(p_support, p_player, 1);
+    PureStrategyProfile profile = (*iter)->Copy();
+    for (int s = 1; s <= m_numStrategies; s++) {
+      profile->SetStrategy(p_strategies[s]);
+      m_offset[s - 1] = profile->GetIndex() - (*iter)->GetIndex();
+    }
+    for (int k = 0; !iter.AtEnd(); iter++, k++) {
+      m_index[k] = (*iter)->GetIndex();
+      for (int s = 1; s <= m_numStrategies; s++) {
+	m_values[(s - 1) * m_numContingencies + k] = 
+	  payoffs[m_index[k] + m_offset[s - 1]];
+      }
     }
   }
   else {
-    for (int st = 1; st <= set.Length(); st++) {
-      set[st] = GetStrategy(p_player, st);
+    // Visiting contingencies in Gray-code order allows tree games to
+    // revise payoffs incrementally
+    m_exactValues = std::vector<Rational>(m_numStrategies * m_numContingencies);
+    StrategyIterator iter(p_support, p_player, 1, true);
+    for (; !iter.AtEnd(); iter++) {
+      int k = iter.GetContingency() - 1;
+      for (int s = 1; s <= m_numStrategies; s++) {
+	int i = (s - 1) * m_numContingencies + k;
+	m_exactValues[i] = (*iter)->GetStrategyValue(p_strategies[s]);
+	m_values[i] = (double) m_exactValues[i];
+	m_exact = m_exact && (Rational(m_values[i]) == m_exactValues[i]);
+      }
     }
   }
 
-  int min = 0, dis = set.Length() - 1;
-
-  while (min <= dis) {
-    int pp;
-    for (pp = 0;
-	 pp < min && !Dominates(set[pp+1], set[dis+1], p_strict);
-	 pp++);
-    if (pp < min)
-      dis--;
-    else  {
-      GameStrategy foo = set[dis+1];
-      set[dis+1] = set[min+1];
-      set[min+1] = foo;
-
-      for (int inc = min + 1; inc <= dis; )  {
-	if (Dominates(set[min+1], set[dis+1], p_strict)) {
-	  //p_tracefile << GetStrategy(p_player, set[dis+1])->GetNumber() << " dominated by " << GetStrategy(p_player, set[min+1])->GetNumber() << '\n';
-	  dis--;
-	}
-	else if (Dominates(set[dis+1], set[min+1], p_strict)) {
-	  //p_tracefile << GetStrategy(p_player, set[min+1])->GetNumber() << " dominated by " << GetStrategy(p_player, set[dis+1])->GetNumber() << '\n';
-	  foo = set[dis+1];
-	  set[dis+1] = set[min+1];
-	  set[min+1] = foo;
-	  dis--;
-	}
-	else  {
-	  foo = set[dis+1];
-	  set[dis+1] = set[inc+1];
-	  set[inc+1] = foo;
-	  inc++;
-	}
-      }
-      min++;
+  if (!m_exact) {
+    // Converting exact payoffs to doubles errs by far less than this,
+    // so differences larger than the tolerance have the right sign
+    double maxabs = 0.0;
+    for (unsigned int i = 0; i < m_values.size(); i++) {
+      if (std::fabs(m_values[i]) > maxabs)  maxabs = std::fabs(m_values[i]);
     }
+    m_tolerance = 1.0e-9 * (1.0 + maxabs);
   }
-    
-  if (min + 1 <= set.Length()) {
-    for (int i = min + 1; i <= set.Length(); i++) {
-      newS.RemoveStrategy(set[i]);
+}
+
+/// Compares the slices of strategies s and t in floating point.
+/// Contingencies are taken in blocks, each with a branch-free loop,
+/// so the compiler can vectorize the loop, and the comparison can stop
+/// early once s is found to do worse than t somewhere.  Differences
+/// within the tolerance are ties; if the doubles are exact, these are
+/// real ties, otherwise the comparison is left UNDECIDED.
+PayoffSlices::Comparison
+PayoffSlices::Compare(int s, int t, bool p_strict) const
+{
+  const int BLOCK = 64;
+  const double *a = &m_values[(s - 1) * m_numContingencies];
+  const double *b = &m_values[(t - 1) * m_numContingencies];
+  const double tol = m_tolerance;
+  int ties = 0;
+
+  for (int start = 0; start < m_numContingencies; start += BLOCK) {
+    int end = (start + BLOCK < m_numContingencies) ? 
+      start + BLOCK : m_numContingencies;
+    int worse = 0;
+    for (int k = start; k < end; k++) {
+      double d = a[k] - b[k];
+      worse += (d < -tol);
+      ties += (d <= tol);
     }
-    
-    return true;
+    if (worse > 0)  return FAILS;
   }
-  else {
-    return false;
+
+  if (ties == 0)  return DOMINATES;
+  if (m_exact) {
+    return (p_strict || ties == m_numContingencies) ? FAILS : DOMINATES;
+  }
+  return UNDECIDED;
+}
+
+/// Decides exactly whether strategy s dominates strategy t.  Only the
+/// contingencies where the doubles tie are compared in exact arithmetic.
+bool PayoffSlices::Dominates(int s, int t, bool p_strict) const
+{
+  Comparison result = Compare(s, t, p_strict);
+  if (result != UNDECIDED)  return (result == DOMINATES);
+
+  const double *a = &m_values[(s - 1) * m_numContingencies];
+  const double *b = &m_values[(t - 1) * m_numContingencies];
+  bool better = false;
+  for (int k = 0; k < m_numContingencies; k++) {
+    if (std::fabs(a[k] - b[k]) > m_tolerance) {
+      better = true;
+      continue;
+    }
+    Rational ap = GetExactValue(s, k), bp = GetExactValue(t, k);
+    if (ap < bp || (p_strict && ap == bp))  return false;
+    if (ap > bp)  better = true;
+  }
+  return better;
+}
+
+}  // end anonymous namespace
+
+bool StrategySupport::Undominated(StrategySupport &newS, 
+				  const Array<int> &p_players,
+				  bool p_strict, bool p_external) const
+{
+  // Extract the payoff slices of the candidate strategies of each player
+  Array<Array<GameStrategy> > sets(p_players.Length());
+  Array<PayoffSlices *> slices(p_players.Length());
+  std::vector<int> taskPlayer, taskStrategy;
+  for (int i = 1; i <= p_players.Length(); i++) {
+    GamePlayer player = m_nfg->GetPlayer(p_players[i]);
+    if (p_external) {
+      for (int st = 1; st <= player->NumStrategies(); 
+	   sets[i].Append(player->GetStrategy(st++)));
+    }
+    else {
+      sets[i] = m_support[p_players[i]];
+    }
+    slices[i] = new PayoffSlices(*this, p_players[i], sets[i]);
+    for (int st = 1; st <= sets[i].Length(); st++) {
+      taskPlayer.push_back(i);
+      taskStrategy.push_back(st);
+    }
+  }
+
+  // Test all candidates, for all players, in parallel; since dominance
+  // is transitive, a strategy is dominated exactly when it is dominated
+  // by some other candidate.  Comparisons which cannot be settled in
+  // floating point are left to be decided exactly afterwards.
+  std::vector<int> status(taskPlayer.size(), PayoffSlices::FAILS);
+  int numTasks = taskPlayer.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif  // _OPENMP
+  for (int task = 0; task < numTasks; task++) {
+    const PayoffSlices &slice = *slices[taskPlayer[task]];
+    int t = taskStrategy[task];
+    for (int s = 1; s <= slice.NumStrategies(); s++) {
+      if (s == t)  continue;
+      PayoffSlices::Comparison result = slice.Compare(s, t, p_strict);
+      if (result == PayoffSlices::DOMINATES) {
+	status[task] = result;
+	break;
+      }
+      else if (result == PayoffSlices::UNDECIDED) {
+	status[task] = result;
+      }
+    }
+  }
+
+  bool removed = false;
+  for (int task = 0; task < numTasks; task++) {
+    const PayoffSlices &slice = *slices[taskPlayer[task]];
+    int t = taskStrategy[task];
+    if (status[task] == PayoffSlices::UNDECIDED) {
+      status[task] = PayoffSlices::FAILS;
+      for (int s = 1; s <= slice.NumStrategies(); s++) {
+	if (s != t && slice.Dominates(s, t, p_strict)) {
+	  status[task] = PayoffSlices::DOMINATES;
+	  break;
+	}
+      }
+    }
+    if (status[task] == PayoffSlices::DOMINATES) {
+      removed = newS.RemoveStrategy(sets[taskPlayer[task]][t]) || removed;
+    }
   }
+
+  for (int i = 1; i <= slices.Length(); delete slices[i++]);
+  return removed;
 }
 
 StrategySupport StrategySupport::Undominated(bool p_strict,
 					     bool p_external) const
 {
   StrategySupport newS(*this);
-
-  for (int pl = 1; pl <= m_nfg->NumPlayers(); pl++)   {
-    Undominated(newS, pl, p_strict, p_external);
+  Array<int> players(m_nfg->NumPlayers());
+  for (int pl = 1; pl <= players.Length(); pl++) {
+    players[pl] = pl;
   }
-
+  Undominated(newS, players, p_strict, p_external);
   return newS;
 }
 
@@ -297,15 +469,21 @@ StrategySupport
 StrategySupport::Undominated(bool p_strict, const Array<int> &players) const
 {
   StrategySupport newS(*this);
-  
-  for (int i = 1; i <= players.Length(); i++)   {
-    //tracefile << "Dominated strategies for player " << pl << ":\n";
-    Undominated(newS, players[i], p_strict);
-  }
-
+  Undominated(newS, players, p_strict);
   return newS;
 }
 
+StrategySupport StrategySupport::IteratedUndominated(bool p_strict,
+						     bool p_external) const
+{
+  StrategySupport support(*this);
+  while (true) {
+    StrategySupport newS = support.Undominated(p_strict, p_external);
+    if (newS == support)  return support;
+    support = newS;
+  }
+}
+
 //---------------------------------------------------------------------------
 //                Identification of overwhelmed strategies
 //---------------------------------------------------------------------------
@@ -314,7 +492,7 @@ bool StrategySupport::Overwhelms(const GameStrategy &s,
 				 const GameStrategy &t, 
 				 bool p_strict) const
 {
-  StrategyIterator iter(*this);
+  StrategyIterator iter(*this, s, true);
   Rational sMin = (*iter)->GetStrategyValue(s);
   Rational tMax = (*iter)->GetStrategyValue(t);
 
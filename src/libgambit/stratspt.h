@@ -75,6 +75,7 @@ class StrategySupport {
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class MixedStrategyProfileRep;
   template <class T> friend class AggMixedStrategyProfileRep;
+  template <class T> friend class TableMixedStrategyProfileRep;
 protected:
   Game m_nfg;
   Array<Array<GameStrategy> > m_support;
@@ -82,7 +83,9 @@ protected:
   /// The index into a strategy profile for a strategy (-1 if not in support)
   Array<int> m_profileIndex;
   
-  bool Undominated(StrategySupport &newS, int p_player, 
+  /// Removes from newS the strategies of the listed players which are
+  /// dominated in this support; returns true if any were removed
+  bool Undominated(StrategySupport &newS, const Array<int> &p_players,
 		   bool p_strict, bool p_external = false) const;
 
 public:
@@ -165,6 +168,10 @@ public:
   /// Returns a copy of the support with dominated strategies eliminated
   StrategySupport Undominated(bool p_strict, bool p_external = false) const;
   StrategySupport Undominated(bool strong, const Array<int> &players) const;
+  /// Returns a copy of the support with dominated strategies eliminated
+  /// iteratively, until none remain
+  StrategySupport IteratedUndominated(bool p_strict, 
+				      bool p_external = false) const;
   //@}
 
   /// @name Identification of overwhelmed strategies
@@ -0,0 +1,74 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/writer.cc
+// Buffered output of game files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "writer.h"
+
+namespace Gambit {
+
+GameFileText &GameFileText::operator<<(long p_value)
+{
+  // Digits are generated from the last; the magnitude is taken as
+  // unsigned so that the most negative long is handled
+  char digits[24];
+  char *p = digits + sizeof(digits);
+  unsigned long value = (p_value < 0) ? -(unsigned long) p_value : p_value;
+  do {
+    *--p = (char) ('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  if (p_value < 0)  *--p = '-';
+  m_text.append(p, digits + sizeof(digits) - p);
+  return *this;
+}
+
+GameFileText &GameFileText::operator<<(const Rational &p_value)
+{
+  const Integer &num = p_value.numerator(), &den = p_value.denominator();
+  if (num.fits_in_long()) {
+    *this << num.as_long();
+  }
+  else {
+    m_text += Itoa(num);
+  }
+  if (den != 1L) {
+    m_text += '/';
+    if (den.fits_in_long()) {
+      *this << den.as_long();
+    }
+    else {
+      m_text += Itoa(den);
+    }
+  }
+  return *this;
+}
+
+void GameFileText::WriteQuoted(const std::string &s)
+{
+  m_text += '"';
+  for (size_t i = 0; i < s.length(); i++) {
+    if (s[i] == '"')   m_text += '\\';
+    m_text += s[i];
+  }
+  m_text += '"';
+}
+
+}  // end namespace Gambit
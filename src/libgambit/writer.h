@@ -0,0 +1,90 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/writer.h
+// Buffered output of game files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_WRITER_H
+#define LIBGAMBIT_WRITER_H
+
+#include <iostream>
+#include <string>
+
+#include "libgambit.h"
+
+namespace Gambit {
+
+//
+// Formats numbers and labels into a string, without going through the
+// formatted output of a stream.  Game files are written by filling
+// these, and passing the text on to the stream in large blocks.
+//
+class GameFileText {
+protected:
+  std::string m_text;
+
+public:
+  /// @name Accessing the text
+  //@{
+  const std::string &GetText(void) const { return m_text; }
+  size_t Length(void) const { return m_text.length(); }
+  void Clear(void) { m_text.clear(); }
+  //@}
+
+  /// @name Formatting
+  //@{
+  GameFileText &operator<<(char c) { m_text += c;  return *this; }
+  GameFileText &operator<<(const char *s) { m_text += s;  return *this; }
+  GameFileText &operator<<(const std::string &s)
+  { m_text += s;  return *this; }
+  GameFileText &operator<<(long);
+  GameFileText &operator<<(int i) { return *this << (long) i; }
+  GameFileText &operator<<(const Rational &);
+
+  /// Writes the string in double quotes, escaping any quotes within it
+  void WriteQuoted(const std::string &);
+  //@}
+};
+
+//
+// Text written to a stream whenever the buffered amount reaches the
+// block size, and when the writer is destroyed.
+//
+class GameFileWriter : public GameFileText {
+private:
+  std::ostream &m_stream;
+
+public:
+  /// The amount of text passed on to the stream at once
+  static const size_t BLOCK_SIZE = 1 << 16;
+
+  GameFileWriter(std::ostream &p_stream) : m_stream(p_stream)
+  { m_text.reserve(2 * BLOCK_SIZE); }
+  ~GameFileWriter() { Flush(); }
+
+  /// Passes the text on to the stream if a block has accumulated
+  void Check(void) { if (m_text.length() >= BLOCK_SIZE)  Flush(); }
+  /// Passes all the text on to the stream
+  void Flush(void)
+  { m_stream.write(m_text.data(), m_text.length());  m_text.clear(); }
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_WRITER_H
@@ -25,6 +25,7 @@
 
 #include "libgambit/libgambit.h"
 #include <map>
+#include <vector>
 
 template <class T> class BFS {
 private:
@@ -66,6 +67,89 @@ public:
       return m_default;
     }
   }
+
+  // The basic variables, in increasing order; two BFS's are equal
+  // exactly when these are equal
+  void GetBasis(std::vector<int> &p_basis) const {
+    p_basis.clear();
+    for (typename std::map<int, T>::const_iterator iter = m_map.begin();
+	 iter != m_map.end(); iter++) {
+      p_basis.push_back((*iter).first);
+    }
+  }
+};
+
+//
+// A set of bases of BFS's, used to recognize solutions which have
+// already been found.  Each basis is stored as its sorted list of
+// basic variables, and located through an open-addressed hash table
+// on that list, so checking a BFS costs time in its basis size,
+// not in the number of solutions found so far.
+//
+class BFSRegistry {
+private:
+  std::vector<int> m_keys;           // all bases, one after the other
+  std::vector<size_t> m_starts;      // where each basis begins in m_keys
+  std::vector<unsigned long> m_hashes;
+  std::vector<long> m_slots;         // index of basis, or -1 if empty
+  std::vector<int> m_basis;
+
+  static unsigned long Hash(const std::vector<int> &p_basis) {
+    // FNV-1a over the basic variables
+    unsigned long h = 2166136261UL;
+    for (size_t i = 0; i < p_basis.size(); i++) {
+      h = (h ^ (unsigned long) p_basis[i]) * 16777619UL;
+    }
+    return h;
+  }
+
+  bool Matches(long p_index, const std::vector<int> &p_basis) const {
+    size_t start = m_starts[p_index], end = m_starts[p_index + 1];
+    if (end - start != p_basis.size())  return false;
+    for (size_t i = 0; i < p_basis.size(); i++) {
+      if (m_keys[start + i] != p_basis[i])  return false;
+    }
+    return true;
+  }
+
+  void Place(long p_index) {
+    size_t mask = m_slots.size() - 1;
+    size_t slot = m_hashes[p_index] & mask;
+    while (m_slots[slot] >= 0)  slot = (slot + 1) & mask;
+    m_slots[slot] = p_index;
+  }
+
+public:
+  BFSRegistry(void) : m_starts(1, 0), m_slots(16, -1L) { }
+
+  /// Number of distinct bases registered
+  int Length(void) const { return (int) m_hashes.size(); }
+
+  /// Registers the basis of the BFS; returns true if it was not
+  /// already registered
+  template <class T> bool Insert(const BFS<T> &p_bfs) {
+    p_bfs.GetBasis(m_basis);
+    unsigned long h = Hash(m_basis);
+    size_t mask = m_slots.size() - 1;
+    for (size_t slot = h & mask; m_slots[slot] >= 0;
+	 slot = (slot + 1) & mask) {
+      long index = m_slots[slot];
+      if (m_hashes[index] == h && Matches(index, m_basis))  return false;
+    }
+
+    m_keys.insert(m_keys.end(), m_basis.begin(), m_basis.end());
+    m_starts.push_back(m_keys.size());
+    m_hashes.push_back(h);
+
+    if (2 * m_hashes.size() > m_slots.size()) {
+      m_slots.assign(2 * m_slots.size(), -1L);
+      for (long i = 0; i < (long) m_hashes.size(); i++)  Place(i);
+    }
+    else {
+      Place((long) m_hashes.size() - 1);
+    }
+    return true;
+  }
 };
 
 #endif   // BFS_H
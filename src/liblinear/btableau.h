@@ -23,6 +23,8 @@
 #ifndef BTABLEAU_H  
 #define BTABLEAU_H
 
+#include <vector>
+#include <utility>
 #include "bfs.h"
 #include "basis.h"
 
@@ -38,6 +40,11 @@ public:
     virtual ~BadPivot() throw() { }
     const char *what(void) const throw() { return "Bad Pivot in BaseTableau"; }
   };
+  class BadCheckpoint : public Gambit::Exception  {
+  public:
+    virtual ~BadCheckpoint() throw() { }
+    const char *what(void) const throw() { return "No checkpoint to roll back to in BaseTableau"; }
+  };
 
   virtual ~BaseTableau() { }
 
@@ -81,6 +88,16 @@ protected:
   T eps1,eps2;
   Gambit::Array<int> artificial;  // artificial variables
 
+  // Pivots made since the earliest checkpoint, as the row pivoted on
+  // and the label which left the basis; and, for each checkpoint, where
+  // it begins in the log and the number of pivots made before it
+  std::vector<std::pair<int, int> > pivotLog;
+  std::vector<std::pair<size_t, long> > checkpoints;
+
+  // records a pivot on the row, if there is a checkpoint to return to
+  void LogPivot(int outrow)
+  { if (!checkpoints.empty()) pivotLog.push_back(std::make_pair(outrow, basis.Label(outrow))); }
+
 public:
   TableauInterface(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &b); 
   TableauInterface(const Gambit::Matrix<T> &A, const Gambit::Array<int> &art, 
@@ -128,6 +145,13 @@ public:
   virtual void Refactor() = 0;
   virtual void SetRefactor(int) = 0;
 
+      // checkpoints -- rolling back undoes the pivots made since the
+      // last checkpoint, instead of copying the tableau beforehand.
+      // Checkpoints nest, and are not copied.  The constraints must
+      // not be changed between a checkpoint and its rollback.
+  virtual void Checkpoint() = 0;
+  virtual void Rollback() = 0;
+
       // miscellaneous functions
   bool EqZero(T x) const;
   bool LtZero(T x) const;
@@ -23,6 +23,7 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
 #include "basis.h"
 
@@ -72,6 +73,23 @@ private:
   const LUdecomp<T> *parent;
   int copycount;
 
+  // The factorization as it was when it was first refactored after a
+  // checkpoint, so that rolling back to the checkpoint can restore it
+  class Factorization {
+  public:
+    Gambit::List< EtaMatrix<T> > L, U, E;
+    Gambit::List< int > P;
+    const LUdecomp<T> *parent;
+  };
+
+  // The state to return to on rolling back to each checkpoint
+  class Mark {
+  public:
+    int etas, iterations, total_operations;
+    Factorization *saved;
+  };
+  std::vector<Mark> marks;
+
   // don't use this copy constructor
   LUdecomp( const LUdecomp<T> &a);
   // don't use the equals operator, use the Copy function instead
@@ -90,6 +108,11 @@ public:
     virtual ~BadCount() throw() { }
     const char *what(void) const throw() { return "Bad reference count in LUdecomp"; }
   };
+  class BadCheckpoint : public Gambit::Exception  {
+  public:
+    virtual ~BadCheckpoint() throw() { }
+    const char *what(void) const throw() { return "No checkpoint to roll back to in LUdecomp"; }
+  };
 
   // ------------------------
   // Constructors, Destructor
@@ -133,6 +156,16 @@ public:
   // if number is < 0, no refactoring is done;
   void SetRefactor( int );
 
+  // marks the current factorization, so that the updates made from
+  // here on can be undone.  Checkpoints nest, and are not copied.
+  void Checkpoint();
+
+  // returns to the factorization at the last checkpoint, and removes
+  // the checkpoint.  The eta file is truncated back to its length at
+  // the checkpoint; if the basis was refactored since, the earlier
+  // factorization is restored.
+  void Rollback();
+
   //-------------------
   // Private Members
   //-------------------
@@ -146,6 +179,8 @@ private:
   bool CheckBasis();
   bool RefactorCheck();
 
+  void ClearMarks();
+
   void BTransE( Gambit::Vector<T> & ) const;
   void FTransE( Gambit::Vector<T> & ) const;
   void BTransU( Gambit::Vector<T> & ) const;
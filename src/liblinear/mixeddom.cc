@@ -0,0 +1,270 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/mixeddom.cc
+// Identification of strategies dominated by mixed strategies
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "mixeddom.h"
+#include "lpsolve.h"
+
+using namespace Gambit;
+
+namespace {
+
+//
+// Payoff differences within this tolerance are treated as ties.  This
+// errs on the side of keeping strategies when computing in floating point.
+//
+inline void Tolerance(double &v)    { v = 1.0e-8; }
+inline void Tolerance(Rational &v)  { v = Rational(0); }
+
+//
+// The payoffs to the player of each of the player's strategies in the
+// support (rows), against each contingency of the other players'
+// strategies in the support (columns)
+//
+template <class T>
+Matrix<T> PayoffMatrix(const StrategySupport &p_support, int p_player)
+{
+  int contingencies = 0;
+  for (StrategyIterator iter(p_support, p_player, 1);
+       !iter.AtEnd(); iter++, contingencies++);
+
+  Matrix<T> values(p_support.NumStrategies(p_player), contingencies);
+  StrategyIterator iter(p_support, p_player, 1);
+  for (int k = 1; !iter.AtEnd(); iter++, k++) {
+    for (int s = 1; s <= values.NumRows(); s++) {
+      values(s, k) =
+	(*iter)->GetStrategyValue(p_support.GetStrategy(p_player, s));
+    }
+  }
+  return values;
+}
+
+//
+// Looks for a belief over the contingencies (columns of p_values) against
+// which strategy p_strategy does at least as well as each of the rivals
+// flagged in p_rivals.  Such a belief exists exactly when the strategy
+// is not strictly dominated by a mixture of the rivals.  If found, the
+// belief is returned in p_belief, which must have one entry per column.
+//
+template <class T>
+bool IsBestResponse(const Matrix<T> &p_values, int p_strategy,
+		    const Array<bool> &p_rivals, Vector<T> &p_belief)
+{
+  T tol;
+  Tolerance(tol);
+
+  int rows = 1;
+  for (int s = 1; s <= p_rivals.Length(); s++) {
+    if (p_rivals[s] && s != p_strategy)  rows++;
+  }
+
+  // Constraints are u(s,q) - u(t,q) <= 0 for each rival s, followed by
+  // the equality sum_k q_k = 1; there is no objective
+  Matrix<T> A(rows, p_values.NumColumns());
+  Vector<T> b(rows), c(p_values.NumColumns());
+  c = (T) 0;
+  int r = 1;
+  for (int s = 1; s <= p_rivals.Length(); s++) {
+    if (!p_rivals[s] || s == p_strategy)  continue;
+    for (int k = 1; k <= p_values.NumColumns(); k++) {
+      A(r, k) = p_values(s, k) - p_values(p_strategy, k);
+    }
+    b[r++] = tol;
+  }
+  for (int k = 1; k <= p_values.NumColumns(); k++) {
+    A(rows, k) = (T) 1;
+  }
+  b[rows] = (T) 1;
+
+  LPSolve<T> lp(A, b, c, 1);
+  if (lp.IsAborted() || !lp.IsFeasible())  return false;
+
+  BFS<T> cbfs;
+  lp.OptBFS(cbfs);
+  for (int k = 1; k <= p_belief.Length(); k++) {
+    p_belief[k] = (cbfs.count(k)) ? cbfs[k] : (T) 0;
+  }
+  return true;
+}
+
+//
+// Flags as undominated each strategy which is a best response (up to
+// the tolerance) to the belief over contingencies p_belief
+//
+template <class T>
+void MarkBestResponses(const Matrix<T> &p_values, const Vector<T> &p_belief,
+		       Array<bool> &p_undominated)
+{
+  T tol;
+  Tolerance(tol);
+
+  Vector<T> payoffs(p_values.NumRows());
+  for (int s = 1; s <= p_values.NumRows(); s++) {
+    payoffs[s] = (T) 0;
+    for (int k = 1; k <= p_values.NumColumns(); k++) {
+      if (p_belief[k] != (T) 0) {
+	payoffs[s] += p_belief[k] * p_values(s, k);
+      }
+    }
+  }
+
+  T best = payoffs[1];
+  for (int s = 2; s <= payoffs.Length(); s++) {
+    if (payoffs[s] > best)  best = payoffs[s];
+  }
+  for (int s = 1; s <= payoffs.Length(); s++) {
+    if (payoffs[s] >= best - tol)  p_undominated[s] = true;
+  }
+}
+
+//
+// Returns true if strategy s does strictly better than strategy t
+// against every contingency
+//
+template <class T>
+bool PureDominates(const Matrix<T> &p_values, int s, int t)
+{
+  T tol;
+  Tolerance(tol);
+
+  for (int k = 1; k <= p_values.NumColumns(); k++) {
+    if (p_values(s, k) <= p_values(t, k) + tol)  return false;
+  }
+  return true;
+}
+
+//
+// Computes which of the player's strategies in the support are strictly
+// dominated by mixed strategies
+//
+template <class T>
+Array<bool> MixedDominated(const StrategySupport &p_support, int p_player)
+{
+  Matrix<T> values(PayoffMatrix<T>(p_support, p_player));
+  int n = values.NumRows();
+
+  Array<bool> dominated(n), undominated(n);
+  for (int s = 1; s <= n; s++) {
+    dominated[s] = undominated[s] = false;
+  }
+  if (n == 1)  return dominated;
+
+  // Best responses to pure contingencies are undominated
+  Vector<T> belief(values.NumColumns());
+  for (int k = 1; k <= values.NumColumns(); k++) {
+    belief = (T) 0;
+    belief[k] = (T) 1;
+    MarkBestResponses(values, belief, undominated);
+  }
+
+  // Strategies dominated by pure strategies need no program
+  for (int t = 1; t <= n; t++) {
+    if (undominated[t])  continue;
+    for (int s = 1; s <= n; s++) {
+      if (s != t && !dominated[s] && PureDominates(values, s, t)) {
+	dominated[t] = true;
+	break;
+      }
+    }
+  }
+
+  // The remaining strategies are each tested against the strategies not
+  // yet found dominated.  Dropping dominated rivals does not change the
+  // outcome, as these are themselves dominated by mixtures of the others.
+  Array<bool> rivals(n);
+  for (int s = 1; s <= n; s++) {
+    rivals[s] = !dominated[s];
+  }
+  for (int t = 1; t <= n; t++) {
+    if (undominated[t] || dominated[t])  continue;
+    if (IsBestResponse(values, t, rivals, belief)) {
+      MarkBestResponses(values, belief, undominated);
+      undominated[t] = true;
+    }
+    else {
+      dominated[t] = true;
+      rivals[t] = false;
+    }
+  }
+
+  return dominated;
+}
+
+}  // end anonymous namespace
+
+template <class T>
+bool IsMixedDominated(const StrategySupport &p_support,
+		      const GameStrategy &p_strategy)
+{
+  int pl = p_strategy->GetPlayer()->GetNumber();
+  int t = p_support.GetIndex(p_strategy);
+  if (t == 0) {
+    throw UndefinedException();
+  }
+  if (p_support.NumStrategies(pl) == 1)  return false;
+
+  Matrix<T> values(PayoffMatrix<T>(p_support, pl));
+  Array<bool> rivals(values.NumRows());
+  for (int s = 1; s <= rivals.Length(); s++) {
+    rivals[s] = true;
+  }
+  Vector<T> belief(values.NumColumns());
+  return !IsBestResponse(values, t, rivals, belief);
+}
+
+template <class T>
+StrategySupport MixedUndominated(const StrategySupport &p_support)
+{
+  StrategySupport newS(p_support);
+
+  for (int pl = 1; pl <= p_support.GetGame()->NumPlayers(); pl++) {
+    Array<bool> dominated(MixedDominated<T>(p_support, pl));
+    for (int s = 1; s <= dominated.Length(); s++) {
+      if (dominated[s]) {
+	newS.RemoveStrategy(p_support.GetStrategy(pl, s));
+      }
+    }
+  }
+
+  return newS;
+}
+
+template <class T>
+StrategySupport IteratedMixedUndominated(const StrategySupport &p_support)
+{
+  StrategySupport support(p_support);
+  while (true) {
+    StrategySupport newS(MixedUndominated<T>(support.IteratedUndominated(true)));
+    if (newS == support)  return support;
+    support = newS;
+  }
+}
+
+template bool IsMixedDominated<double>(const StrategySupport &,
+				       const GameStrategy &);
+template bool IsMixedDominated<Rational>(const StrategySupport &,
+					 const GameStrategy &);
+template StrategySupport MixedUndominated<double>(const StrategySupport &);
+template StrategySupport MixedUndominated<Rational>(const StrategySupport &);
+template StrategySupport
+IteratedMixedUndominated<double>(const StrategySupport &);
+template StrategySupport
+IteratedMixedUndominated<Rational>(const StrategySupport &);
@@ -0,0 +1,63 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/mixeddom.h
+// Identification of strategies dominated by mixed strategies
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef MIXEDDOM_H
+#define MIXEDDOM_H
+
+#include "libgambit/libgambit.h"
+
+//
+// These functions identify strategies which are strictly dominated,
+// against the strategies of the other players in a support, by a mixed
+// strategy over the player's other strategies in the support.  A
+// strategy is undominated in this sense exactly when it is a best
+// response to some belief over the other players' contingencies; this
+// is decided by solving a linear program with one row per strategy of
+// the player, using LPSolve.
+//
+// Many strategies can be shown to be undominated without solving any
+// program: those which are best responses to some pure contingency, or
+// to a belief found while testing another strategy.  Strategies found
+// dominated are dropped from the programs solved afterwards.
+//
+// The computations are done in the arithmetic T (double or Rational).
+// Weak dominance by mixed strategies is not offered, as strategies so
+// dominated cannot be removed all at once.
+//
+
+/// Returns true if the strategy is strictly dominated by a mixed strategy
+/// over the player's other strategies in the support
+template <class T>
+bool IsMixedDominated(const Gambit::StrategySupport &p_support,
+		      const Gambit::GameStrategy &p_strategy);
+
+/// Returns a copy of the support, with all strategies strictly dominated
+/// by mixed strategies removed
+template <class T> Gambit::StrategySupport
+MixedUndominated(const Gambit::StrategySupport &p_support);
+
+/// Returns a copy of the support, with strategies strictly dominated
+/// by pure or mixed strategies eliminated iteratively, until none remain
+template <class T> Gambit::StrategySupport
+IteratedMixedUndominated(const Gambit::StrategySupport &p_support);
+
+#endif   // MIXEDDOM_H
@@ -55,6 +55,7 @@ Tableau<double>& Tableau<double>::operator=(const Tableau<double> &orig)
   if(this!= &orig) {
     B.Copy(orig.B,*this);
     tmpcol = orig.tmpcol;
+    savedSolutions.clear();
   }
   return *this;
 }
@@ -80,6 +81,7 @@ void Tableau<double>::Pivot(int outrow,int col)
   // gout << " outlabel: " << outlabel;
   // gout << " inlabel: " << col;
   // BigDump(gout);
+  LogPivot(outrow);
   basis.Pivot(outrow,col);
   
   B.update(outrow, col);
@@ -117,6 +119,30 @@ void Tableau<double>::SetRefactor(int n)
   B.SetRefactor(n);
 }
 
+void Tableau<double>::Checkpoint()
+{
+  checkpoints.push_back(std::make_pair(pivotLog.size(), npivots));
+  savedSolutions.push_back(solution);
+  B.Checkpoint();
+}
+
+void Tableau<double>::Rollback()
+{
+  if (checkpoints.empty()) throw BadCheckpoint();
+  // The basis is pivoted back directly; the factorization returns to
+  // its state at the checkpoint by truncating the eta file
+  size_t mark = checkpoints.back().first;
+  for (size_t k = pivotLog.size(); k > mark; k--) {
+    basis.Pivot(pivotLog[k-1].first, pivotLog[k-1].second);
+  }
+  pivotLog.resize(mark);
+  npivots = checkpoints.back().second;
+  checkpoints.pop_back();
+  B.Rollback();
+  solution = savedSolutions.back();
+  savedSolutions.pop_back();
+}
+
 void Tableau<double>::SetConst(const Gambit::Vector<double> &bnew)
 {
   if(bnew.First()!=b->First() || bnew.Last()!=b->Last())
@@ -319,6 +345,7 @@ void Tableau<Gambit::Rational>::Pivot(int outrow,int in_col)
   if(!RowIndex(outrow) || !ValidIndex(in_col)) 
     throw BadPivot();
   int outlabel = Label(outrow);
+  LogPivot(outrow);
 
   // gout << "\noutrow:" << outrow;
   // gout << " outlabel: " << outlabel;
@@ -475,6 +502,27 @@ void Tableau<Gambit::Rational>::Refactor()
 void Tableau<Gambit::Rational>::SetRefactor(int)
 { }
 
+void Tableau<Gambit::Rational>::Checkpoint()
+{
+  checkpoints.push_back(std::make_pair(pivotLog.size(), npivots));
+}
+
+void Tableau<Gambit::Rational>::Rollback()
+{
+  if (checkpoints.empty()) throw BadCheckpoint();
+  // Integer pivoting gives the same tableau for the same basis, so
+  // pivoting the leaving labels back in restores it exactly, at the
+  // cost of a pivot for each one undone.  These pivots are logged
+  // beyond the mark, and discarded with the rest.
+  size_t mark = checkpoints.back().first;
+  for (size_t k = pivotLog.size(); k > mark; k--) {
+    Tableau<Gambit::Rational>::Pivot(pivotLog[k-1].first, pivotLog[k-1].second);
+  }
+  pivotLog.resize(mark);
+  npivots = checkpoints.back().second;
+  checkpoints.pop_back();
+}
+
 void Tableau<Gambit::Rational>::SetConst(const Gambit::Vector<Gambit::Rational> &bnew)
 {
   b=&bnew;
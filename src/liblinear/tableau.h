@@ -44,6 +44,7 @@ class Tableau<double> : public TableauInterface<double>{
 private:
   LUdecomp<double> B;     // LU decomposition
   Gambit::Vector<double> tmpcol; // temporary column vector, to avoid allocation
+  std::vector<Gambit::Vector<double> > savedSolutions; // at each checkpoint
 
 public:
       // constructors and destructors
@@ -67,6 +68,8 @@ public:
 
   void Refactor();
   void SetRefactor(int);
+  void Checkpoint();
+  void Rollback();
 
   void SetConst(const Gambit::Vector<double> &bnew);
   void SetBasis( const Basis &); // set new Tableau
@@ -122,6 +125,8 @@ public:
 
   void Refactor();
   void SetRefactor(int);
+  void Checkpoint();
+  void Rollback();
 
   void SetConst(const Gambit::Vector<Gambit::Rational> &bnew);
   void SetBasis( const Basis &); // set new Tableau
@@ -0,0 +1,159 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2013, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/convert/convert.cc
+// Convert a game between file formats
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <unistd.h>
+#include <getopt.h>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#include "libgambit/libgambit.h"
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Convert a Gambit game file to another format\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2013, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS] [file]\n";
+  std::cerr << "If file is not specified, attempts to read game from standard input.\n";
+  std::cerr << "Reads a game in any format Gambit understands, and writes it out\n";
+  std::cerr << "in the specified format\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -f FORMAT        format to write: binary (default), nfg, efg, or\n";
+  std::cerr << "                   native (the format matching the representation)\n";
+  std::cerr << "  -o FILE          file to write to (default is standard output)\n";
+  std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -v, --version    print version information\n";
+  exit(1);
+}
+
+
+int main(int argc, char *argv[])
+{
+  int c;
+  std::string format = "binary", outputFile;
+  bool quiet = false;
+
+  int long_opt_index = 0;
+  struct option long_options[] = {
+    { "help", 0, NULL, 'h'   },
+    { "version", 0, NULL, 'v'  },
+    { 0,    0,    0,    0   }
+  };
+  while ((c = getopt_long(argc, argv, "f:o:hvq", long_options, &long_opt_index)) != -1) {
+    switch (c) {
+    case 'v':
+      PrintBanner(std::cerr); exit(1);
+    case 'f':
+      format = optarg;
+      break;
+    case 'o':
+      outputFile = optarg;
+      break;
+    case 'q':
+      quiet = true;
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  if (format != "binary" && format != "nfg" &&
+      format != "efg" && format != "native") {
+    std::cerr << argv[0] << ": Unknown format `" << format << "'.\n";
+    return 1;
+  }
+
+  std::istream* input_stream = &std::cin;
+  std::ifstream file_stream;
+  if (optind < argc) {
+    file_stream.open(argv[optind], std::ios::in | std::ios::binary);
+    if (!file_stream.is_open()) {
+      std::ostringstream error_message;
+      error_message << argv[0] << ": " << argv[optind];
+      perror(error_message.str().c_str());
+      exit(1);
+    }
+    input_stream = &file_stream;
+  }
+
+  try {
+    Gambit::Game game = Gambit::ReadGame(*input_stream);
+
+    // The output is assembled in memory first, so that a game which
+    // cannot be written in the format does not leave a partial file
+    std::ostringstream output;
+    game->Write(output, format);
+
+    if (outputFile == "") {
+      std::cout << output.str();
+    }
+    else {
+      std::ofstream output_stream(outputFile.c_str(),
+				  std::ios::out | std::ios::binary);
+      if (!output_stream.is_open()) {
+	std::ostringstream error_message;
+	error_message << argv[0] << ": " << outputFile;
+	perror(error_message.str().c_str());
+	exit(1);
+      }
+      output_stream << output.str();
+    }
+    return 0;
+  }
+  catch (Gambit::InvalidFileException) {
+    std::cerr << "Error: Game not in a recognized format.\n";
+    return 1;
+  }
+  catch (Gambit::UndefinedException) {
+    std::cerr << "Error: Game cannot be written in format `" << format << "'.\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Error: An internal error occurred.\n";
+    return 1;
+  }
+}
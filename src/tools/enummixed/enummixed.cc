@@ -29,6 +29,7 @@
 #include <iomanip>
 
 #include "libgambit/libgambit.h"
+#include "liblinear/mixeddom.h"
 #include "clique.h"
 #include "vertenum.imp"
 
@@ -312,6 +313,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -d DECIMALS      compute using floating-point arithmetic;\n";
   std::cerr << "                   display results with DECIMALS digits\n";
   std::cerr << "  -D               don't eliminate dominated strategies first\n";
+  std::cerr << "  -M               also eliminate strategies dominated by\n";
+  std::cerr << "                   mixed strategies\n";
   std::cerr << "  -L               use lrslib for enumeration (experimental!)\n";
   std::cerr << "  -c               output connectedness information\n";
   std::cerr << "  -h, --help       print this help message\n";
@@ -324,6 +327,7 @@ int main(int argc, char *argv[])
 {
   int c;
   bool useFloat = false, uselrs = false, quiet = false, eliminate = true;
+  bool eliminateMixed = false;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -331,7 +335,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqcS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DMvhqcS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -342,6 +346,9 @@ int main(int argc, char *argv[])
     case 'D':
       eliminate = false;
       break;
+    case 'M':
+      eliminateMixed = true;
+      break;
     case 'L':
       uselrs = true;
       break;
@@ -395,12 +402,12 @@ int main(int argc, char *argv[])
     }
 
     StrategySupport support(game);
-    if (eliminate) {
-      while (true) {
-	StrategySupport newSupport = support.Undominated(true);
-	if (newSupport == support) break;
-	support = newSupport;
-      }
+    if (eliminate && eliminateMixed) {
+      support = (useFloat) ? IteratedMixedUndominated<double>(support) :
+	IteratedMixedUndominated<Rational>(support);
+    }
+    else if (eliminate) {
+      support = support.IteratedUndominated(true);
     }
 
     if (uselrs) {
@@ -26,8 +26,14 @@
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <vector>
+#include <string>
 #include "libgambit/libgambit.h"
+#include "libgambit/gametable.h"
 #include "libgambit/subgame.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
 
 using namespace Gambit;
 
@@ -46,33 +52,67 @@ void PrintProfile(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
+namespace {
+
+//
+// Returns true if no player can gain by changing the action at any one
+// of the player's information sets
+//
+bool IsNash(const Game &p_efg, const PureBehavProfile &p_profile)
+{
+  for (GamePlayerIterator player = p_efg->Players(); 
+       !player.AtEnd(); player++)  {
+    Rational current = p_profile.GetPayoff<Rational>(player);
+	
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      for (int act = 1; act <= infoset->NumActions(); act++) {
+	if (p_profile.GetPayoff<Rational>(infoset->GetAction(act)) > current)  {
+	  return false;
+	}
+      }
+    }
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
+//
+// The contingencies are split into p_numThreads contiguous ranges, which
+// are checked concurrently.  The equilibria found in each range are
+// collected, then reported in the order the contingencies are visited.
+// The game must be frozen if more than one thread is used.
+//
 List<MixedBehavProfile<Rational> > SolveBehav(const BehavSupport &p_support,
-					      bool p_print = false)
+					      bool p_print = false,
+					      int p_numThreads = 1)
 {
   List<MixedBehavProfile<Rational> > solutions;
 
   Game efg = p_support.GetGame();
 
-  for (BehavIterator citer(p_support); !citer.AtEnd(); citer++) {
-    bool isNash = true;
-
-    for (GamePlayerIterator player = efg->Players(); 
-	 isNash && !player.AtEnd(); player++)  {
-      Rational current = citer->GetPayoff<Rational>(player);
-	
-      for (int iset = 1; isNash && iset <= player->NumInfosets(); iset++) {
-	GameInfoset infoset = player->GetInfoset(iset);
-	for (int act = 1; act <= infoset->NumActions(); act++) {
-	  GameAction action = infoset->GetAction(act);
-	  if (citer->GetPayoff<Rational>(action) > current)  {
-	    isNash = false;
-	    break;
-	  }
-	}
+  long size = 0;
+  for (BehavIterator citer(p_support); !citer.AtEnd(); citer++, size++);
+
+  std::vector<std::vector<PureBehavProfile> > found(p_numThreads);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(p_numThreads)
+#endif // _OPENMP
+  for (int range = 0; range < p_numThreads; range++) {
+    long first = size * range / p_numThreads;
+    long last = size * (range + 1) / p_numThreads;
+    BehavIterator citer(p_support);
+    for (long k = 0; k < first; k++, citer++);
+    for (long k = first; k < last; k++, citer++) {
+      if (IsNash(efg, *citer)) {
+	found[range].push_back(*citer);
       }
     }
-      
-    if (isNash)  {
+  }
+
+  for (int range = 0; range < p_numThreads; range++) {
+    for (unsigned int i = 0; i < found[range].size(); i++) {
       MixedBehavProfile<Rational> temp(efg);
       // zero out all the entries, since any equilibria are pure
       ((Vector<Rational> &) temp).operator=(Rational(0));
@@ -80,7 +120,7 @@ List<MixedBehavProfile<Rational> > SolveBehav(const BehavSupport &p_support,
       for (GamePlayerIterator player = efg->Players();
 	   !player.AtEnd(); player++) {
 	for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-	  temp(citer->GetAction(player->GetInfoset(iset))) = 1;
+	  temp(found[range][i].GetAction(player->GetInfoset(iset))) = 1;
 	}
       }
 
@@ -115,36 +155,163 @@ void PrintProfile(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
-void SolveMixed(Game p_nfg)
+namespace {
+
+//
+// The payoffs to each player in each contingency of a strategic game.
+// Contingencies are numbered from zero, with the first player's strategy
+// varying fastest.  The payoff tables of table games are used directly;
+// for other games, payoffs are computed once, visiting contingencies in
+// Gray-code order so that successive payoffs are revised incrementally.
+// The payoffs of frozen games may be computed using several threads.
+//
+class ContingencyPayoffs {
+private:
+  long m_size;
+  Array<const Array<Rational> *> m_tables;
+  std::vector<long> m_index;
+  std::vector<Rational> m_values;
+
+public:
+  ContingencyPayoffs(const StrategySupport &p_support, int p_numThreads);
+
+  long NumContingencies(void) const { return m_size; }
+  const Rational &operator()(int pl, long k) const
+  { return (m_index.empty()) ? m_values[(pl - 1) * m_size + k] : 
+      (*m_tables[pl])[m_index[k]]; }
+};
+
+ContingencyPayoffs::ContingencyPayoffs(const StrategySupport &p_support,
+				       int p_numThreads)
+  : m_tables(p_support.GetGame()->NumPlayers())
 {
-  for (StrategyIterator citer(p_nfg); !citer.AtEnd(); citer++) {
-    bool flag = true;
-
-    for (GamePlayerIterator player = p_nfg->Players(); 
-	 flag && !player.AtEnd(); player++)  {
-      Rational current = (*citer)->GetPayoff(player);
-      PureStrategyProfile p = (*citer)->Copy(); 
-      for (GameStrategyIterator strategy = player->Strategies();
-	   !strategy.AtEnd(); strategy++) {
-	if (p->GetStrategyValue(strategy) > current)  {
-	  flag = false;
-	  break;
+  Game game = p_support.GetGame();
+  StrategyIterator citer(p_support, true);
+  m_size = citer.NumContingencies();
+
+  if (!game->IsTree() && !game->IsAgg()) {
+    const GameTableRep &table = dynamic_cast<const GameTableRep &>(*game);
+    m_index = std::vector<long>(m_size);
+    for (; !citer.AtEnd(); citer++) {
+      m_index[citer.GetContingency() - 1] = (*citer)->GetIndex();
+    }
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      m_tables[pl] = &table.GetPayoffTable<Rational>(pl);
+      // Reducing all payoffs now leaves nothing to be written to them
+      // when they are compared concurrently
+      for (int i = 1; i <= m_tables[pl]->Length(); i++) {
+	(*m_tables[pl])[i].numerator();
+      }
+    }
+  }
+  else if (!game->IsFrozen() || p_numThreads == 1) {
+    m_values = std::vector<Rational>(game->NumPlayers() * m_size);
+    for (; !citer.AtEnd(); citer++) {
+      long k = citer.GetContingency() - 1;
+      for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+	m_values[(pl - 1) * m_size + k] = (*citer)->GetPayoff(pl);
+	m_values[(pl - 1) * m_size + k].numerator();
+      }
+    }
+  }
+  else {
+    // Each strategy of the last player fixes a contiguous range of
+    // contingencies, and these ranges are filled concurrently
+    m_values = std::vector<Rational>(game->NumPlayers() * m_size);
+    int last = game->NumPlayers();
+    int numStrategies = p_support.NumStrategies(last);
+    long stride = m_size / numStrategies;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(p_numThreads)
+#endif // _OPENMP
+    for (int st = 1; st <= numStrategies; st++) {
+      for (StrategyIterator iter(p_support, last, st, true);
+	   !iter.AtEnd(); iter++) {
+	long k = (st - 1) * stride + iter.GetContingency() - 1;
+	for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+	  m_values[(pl - 1) * m_size + k] = (*iter)->GetPayoff(pl);
+	  m_values[(pl - 1) * m_size + k].numerator();
 	}
       }
     }
-    
-    if (flag)  {
-      MixedStrategyProfile<Rational> temp(p_nfg->NewMixedStrategyProfile(Rational(0)));
-      ((Vector<Rational> &) temp).operator=(Rational(0));
-      PureStrategyProfile profile = (*citer)->Copy();
-      for (GamePlayerIterator player = p_nfg->Players();
-	   !player.AtEnd(); player++) {
-	temp[profile->GetStrategy(player)] = 1;
+  }
+}
+
+//
+// Clears the flags of the contingencies in which player pl's strategy
+// is not a best response.  The contingencies in which the other players'
+// strategies are fixed form a fiber along the player's axis, and the
+// fibers are scanned in parallel.
+//
+void ClearNonBestResponses(const ContingencyPayoffs &p_payoffs, int pl,
+			   long p_stride, int p_numStrategies,
+			   std::vector<unsigned char> &p_isNash)
+{
+  long numFibers = p_payoffs.NumContingencies() / p_numStrategies;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif // _OPENMP
+  for (long f = 0; f < numFibers; f++) {
+    long base = (f % p_stride) + (f / p_stride) * p_stride * p_numStrategies;
+    const Rational *best = &p_payoffs(pl, base);
+    for (int st = 2; st <= p_numStrategies; st++) {
+      const Rational &payoff = p_payoffs(pl, base + (st - 1) * p_stride);
+      if (payoff > *best)  best = &payoff;
+    }
+    for (int st = 1; st <= p_numStrategies; st++) {
+      long k = base + (st - 1) * p_stride;
+      if (p_payoffs(pl, k) < *best)  p_isNash[k] = 0;
+    }
+  }
+}
+
+} // end anonymous namespace
+
+//
+// Pure strategy equilibria are the contingencies in which every player's
+// strategy is a best response.  These are found by a max-reduction along
+// each player's axis of the payoff tables, then printed in the order of
+// the contingencies.  In compact form, each equilibrium is printed as the
+// numbers of the strategies played, rather than as a mixed profile.
+//
+void SolveMixed(Game p_nfg, bool p_compact, int p_numThreads = 1)
+{
+  StrategySupport support(p_nfg);
+  ContingencyPayoffs payoffs(support, p_numThreads);
+  int numPlayers = p_nfg->NumPlayers();
+
+  Array<long> stride(numPlayers);
+  stride[1] = 1L;
+  for (int pl = 2; pl <= numPlayers; pl++) {
+    stride[pl] = stride[pl - 1] * p_nfg->GetPlayer(pl - 1)->NumStrategies();
+  }
+
+  std::vector<unsigned char> isNash(payoffs.NumContingencies(), 1);
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    ClearNonBestResponses(payoffs, pl, stride[pl], 
+			  p_nfg->GetPlayer(pl)->NumStrategies(), isNash);
+  }
+
+  std::string line;
+  for (long k = 0; k < payoffs.NumContingencies(); k++) {
+    if (!isNash[k])  continue;
+    line = "NE";
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      int numStrategies = p_nfg->GetPlayer(pl)->NumStrategies();
+      int played = (k / stride[pl]) % numStrategies + 1;
+      if (p_compact) {
+	line += ',' + lexical_cast<std::string>(played);
+      }
+      else {
+	for (int st = 1; st <= numStrategies; st++) {
+	  line += (st == played) ? ",1" : ",0";
+	}
       }
-      
-      PrintProfile(std::cout, temp);
     }
+    line += '\n';
+    std::cout << line;
   }
+  std::cout.flush();
 }
 
 
@@ -165,6 +332,10 @@ void PrintHelp(char *progname)
   std::cerr << "Options:\n";
   std::cerr << "  -S               use strategic game\n";
   std::cerr << "  -P               find only subgame-perfect equilibria\n";
+  std::cerr << "  -c               on the strategic game, print each equilibrium\n";
+  std::cerr << "                   compactly, as the strategy numbers played\n";
+  std::cerr << "  -t THREADS       number of threads to use in the search\n";
+  std::cerr << "                   (default is the number of processors)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -176,6 +347,11 @@ int main(int argc, char *argv[])
 {
   opterr = 0;
   bool quiet = false, useStrategic = false, bySubgames = false;
+  bool compact = false;
+  int numThreads = 1;
+#ifdef _OPENMP
+  numThreads = omp_get_max_threads();
+#endif // _OPENMP
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -184,7 +360,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "vhqSP", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "vhqSPct:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -194,6 +370,13 @@ int main(int argc, char *argv[])
     case 'P':
       bySubgames = true;
       break;
+    case 'c':
+      compact = true;
+      break;
+    case 't':
+      numThreads = atoi(optarg);
+      if (numThreads < 1)  numThreads = 1;
+      break;
     case 'h':
       PrintHelp(argv[0]);
       break;
@@ -232,9 +415,22 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+#ifdef _OPENMP
+    omp_set_num_threads(numThreads);
+#else
+    numThreads = 1;
+#endif // _OPENMP
+
+    // The game is only read from here on, and so can be shared by the
+    // threads of the search.  Solving by subgames builds and modifies
+    // copies of the subgames, which are searched by a single thread.
+    if (numThreads > 1 && !game->IsAgg() &&
+	(!game->IsTree() || useStrategic || !bySubgames)) {
+      game->Freeze();
+    }
 
     if (!game->IsTree() || useStrategic) {
-      SolveMixed(game);
+      SolveMixed(game, compact, numThreads);
     }
     else {
       if (bySubgames) {
@@ -246,7 +442,7 @@ int main(int argc, char *argv[])
 	}
       }
       else {
-	SolveBehav(game, true);
+	SolveBehav(game, true, numThreads);
       }
     }
     return 0;
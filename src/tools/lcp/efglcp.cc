@@ -42,9 +42,6 @@ namespace {
 // has been reached.  A convenience for unraveling a potentially
 // deep recursion.
 //
-// FIXME: There is an identical twin of this in nfglcp.cc.  This should be
-// refactored into a more generally-useful and generally-visible location.
-//
 class EquilibriumLimitReachedEfg : public Exception {
 public:
   virtual ~EquilibriumLimitReachedEfg() throw() { }
@@ -157,7 +154,7 @@ template <class T> class SolveEfgLcp {
 private:
   int ns1,ns2,ni1,ni2;
   T maxpay,eps;
-  List<BFS<T> > m_list;
+  BFSRegistry m_found;
   List<GameInfoset> isets1, isets2;
 
   void FillTableau(const BehavSupport &, Matrix<T> &, const GameNode &, T,
@@ -232,7 +229,7 @@ SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
   isets1 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(1));
   isets2 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(2));
 
-  m_list = List<BFS<T> >();
+  m_found = BFSRegistry();
 
   int ntot;
   ns1 = p_support.NumSequences(1);
@@ -318,9 +315,7 @@ template <class T> int SolveEfgLcp<T>::AddBFS(const LTableau<T> &tableau)
     }
   }
 
-  if (m_list.Contains(cbfs))  return 0;
-  m_list.Append(cbfs);
-  return 1;
+  return (m_found.Insert(cbfs)) ? 1 : 0;
 }
 
 //
@@ -28,6 +28,9 @@
 #include <getopt.h>
 #include "libgambit/libgambit.h"
 #include "libgambit/subgame.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
 
 using namespace Gambit;
 
@@ -61,6 +64,10 @@ void PrintHelp(char *progname)
   std::cerr << "  -r DEPTH         terminate recursion at DEPTH\n";
   std::cerr << "                   (only if number of equilibria sought is not 1)\n";
   std::cerr << "  -D               print detailed information about equilibria\n";
+  std::cerr << "  -M               on the strategic game, first eliminate strategies\n";
+  std::cerr << "                   dominated by pure or mixed strategies\n";
+  std::cerr << "  -t THREADS       number of threads to use on the strategic game\n";
+  std::cerr << "                   (equilibria are then reported in the order found)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -71,6 +78,8 @@ int g_numDecimals = 6;
 bool g_printDetail = false;
 int g_stopAfter = 0;
 int g_maxDepth = 0;
+bool g_eliminateMixed = false;
+int g_numThreads = 1;
 
 extern void PrintProfile(std::ostream &, const std::string &,
 			 const MixedBehavProfile<double> &);
@@ -82,6 +91,9 @@ int main(int argc, char *argv[])
 {
   int c;
   bool useFloat = false, useStrategic = false, bySubgames = false, quiet = false;
+#ifdef _OPENMP
+  g_numThreads = omp_get_max_threads();
+#endif // _OPENMP
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -89,7 +101,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqSPe:r:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DMvhqSPe:r:t:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -100,6 +112,9 @@ int main(int argc, char *argv[])
     case 'D':
       g_printDetail = true;
       break;
+    case 'M':
+      g_eliminateMixed = true;
+      break;
     case 'e':
       g_stopAfter = atoi(optarg);
       break;
@@ -118,6 +133,10 @@ int main(int argc, char *argv[])
     case 'P':
       bySubgames = true;
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      if (g_numThreads < 1)  g_numThreads = 1;
+      break;
     case '?':
       if (isprint(optopt)) {
 	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
@@ -150,6 +169,9 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+#ifndef _OPENMP
+    g_numThreads = 1;
+#endif // _OPENMP
 
     if (game->NumPlayers() != 2) {
       std::cerr << "Error: Game does not have two players.\n";
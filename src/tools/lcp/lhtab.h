@@ -61,6 +61,11 @@ public:
   
       // raw Tableau functions
   void Refactor();
+
+      // checkpoints -- rolling back undoes the pivots made since the
+      // last checkpoint, in both tableaus
+  void Checkpoint();
+  void Rollback();
   
       // miscellaneous functions
   BFS<T> GetBFS(void);
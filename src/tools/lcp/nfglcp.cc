@@ -25,28 +25,75 @@
 #include <iostream>
 
 #include "libgambit/libgambit.h"
+#include "liblinear/mixeddom.h"
 #include "lhtab.h"
 
 using namespace Gambit;
 
-extern int g_numDecimals, g_stopAfter, g_maxDepth;
-extern bool g_printDetail;
+extern int g_numDecimals, g_stopAfter, g_maxDepth, g_numThreads;
+extern bool g_printDetail, g_eliminateMixed;
 
 namespace {
 //
-// Pseudo-exception raised when maximum number of equilibria to compute
-// has been reached.  A convenience for unraveling a potentially
-// deep recursion.
+// The state shared by the tasks following Lemke paths: the bases of
+// the equilibria found so far, and whether the search is to stop,
+// because enough equilibria have been found, or a path has failed.
+// It is accessed only in the critical section GambitLcpFound.
 //
-// FIXME: There is an identical twin of this in efglcp.cc.  This should be
-// refactored into a more generally-useful and generally-visible location.
-//
-class EquilibriumLimitReachedNfg : public Exception {
+class LemkeSearch {
 public:
-  virtual ~EquilibriumLimitReachedNfg() throw() { }
-  const char *what(void) const throw() { return "Reached target number of equilibria"; }
+  BFSRegistry m_found;
+  bool m_stop, m_failed;
+
+  LemkeSearch(void) : m_stop(false), m_failed(false) { }
+
+  /// Returns true if the search is to stop
+  bool IsStopped(void) const {
+    bool stopped;
+#pragma omp critical(GambitLcpFound)
+    stopped = m_stop;
+    return stopped;
+  }
+  /// Stops the search, after a path has raised an exception
+  void Fail(void) {
+#pragma omp critical(GambitLcpFound)
+    m_stop = m_failed = true;
+  }
 };
 
+//
+// Rationals are reduced to lowest terms lazily, when they are read.
+// The matrices of the tableau are read by all the threads of the
+// search, so their entries are brought to lowest terms beforehand.
+//
+inline void Reduce(double) { }
+inline void Reduce(const Rational &x) { x.numerator(); }
+
+template <class T> void Reduce(const Matrix<T> &p_matrix)
+{
+  for (int i = p_matrix.MinRow(); i <= p_matrix.MaxRow(); i++) {
+    for (int j = p_matrix.MinCol(); j <= p_matrix.MaxCol(); j++) {
+      Reduce(p_matrix(i, j));
+    }
+  }
+}
+
+template <class T> void Reduce(const Vector<T> &p_vector)
+{
+  for (int i = p_vector.First(); i <= p_vector.Last(); i++) {
+    Reduce(p_vector[i]);
+  }
+}
+
+//
+// Whether the search backtracks by rolling a tableau back rather than
+// by copying it.  A floating-point tableau rolls back by discarding the
+// updates to its factorization; an exact one would have to pivot back,
+// which costs as much again as the pivots themselves.
+//
+inline bool RollsBack(double) { return true; }
+inline bool RollsBack(const Rational &) { return false; }
+
 } // end anonymous namespace
 
 
@@ -119,22 +166,19 @@ template <class T> Vector<T> Make_b2(const StrategySupport &);
 
 //
 // Function called when a CBFS is encountered.
-// If it is not already in the list p_list, it is added.
+// If its basis is not already registered in the search, it is added.
 // The corresponding equilibrium is computed and output.
-// Returns 'true' if the CBFS is new; 'false' if it already appears in the
-// list.
+// Returns 'true' if the CBFS is new; 'false' if it was already found.
+// Called only in the critical section GambitLcpFound.
 //
 template <class T>
 bool OnBFS(const StrategySupport &p_support,
-	   List<BFS<T> > &p_list, LHTableau<T> &p_tableau)
+	   LemkeSearch &p_search, BFS<T> &cbfs)
 {
-  BFS<T> cbfs(p_tableau.GetBFS());
-  if (p_list.Contains(cbfs)) {
+  if (!p_search.m_found.Insert(cbfs)) {
     return false;
   }
 
-  p_list.Append(cbfs);
-
   MixedStrategyProfile<T> profile(p_support.NewMixedStrategyProfile<T>());
   int n1 = p_support.NumStrategies(1);
   int n2 = p_support.NumStrategies(2);
@@ -173,82 +217,129 @@ bool OnBFS(const StrategySupport &p_support,
     }
   }
   
-  PrintProfile(std::cout, "NE", profile);
+  PrintProfile(std::cout, "NE", profile.ToFullSupport());
   if (g_printDetail) {
-    PrintProfileDetail(std::cout, profile);
+    PrintProfileDetail(std::cout, profile.ToFullSupport());
   }
 
-  if (g_stopAfter > 0 && p_list.Length() >= g_stopAfter) {
-    throw EquilibriumLimitReachedNfg();
+  if (g_stopAfter > 0 && p_search.m_found.Length() >= g_stopAfter) {
+    p_search.m_stop = true;
   }
 
   return true;
 }
 
+template <class T> void AllLemke(const StrategySupport &p_support,
+				 int j, LHTableau<T> &B,
+				 LemkeSearch &p_search,
+				 int depth);
+
 //
-// AllLemke finds all accessible Nash equilibria by recursively 
-// calling itself.  p_list maintains the list of basic variables 
-// for the equilibria that have already been found.  
-// From each new accessible equilibrium, it follows
-// all possible paths, adding any new equilibria to the List.  
+// Follows the path along label i out of the equilibrium at the tableau
+// B, found at the given depth, pivoting B.  If the path ends at a new
+// equilibrium, the search goes on from there.
+//
+template <class T> void FollowPath(const StrategySupport &p_support,
+				   int i, LHTableau<T> &B,
+				   LemkeSearch &p_search,
+				   int depth)
+{
+  if (p_search.IsStopped())  return;
+
+  try {
+    B.LemkePath(i);
+    BFS<T> cbfs(B.GetBFS());
+    bool isNew;
+#pragma omp critical(GambitLcpFound)
+    isNew = OnBFS(p_support, p_search, cbfs);
+    if (isNew && !p_search.IsStopped()) {
+      AllLemke(p_support, i, B, p_search, depth+1);
+    }
+  }
+  catch (...) {
+    p_search.Fail();
+  }
+}
+
+//
+// AllLemke finds all accessible Nash equilibria, by following each
+// path out of the accessible equilibrium at the tableau B, other than
+// the one along label j, and calling itself from each new equilibrium
+// at the end of a path.  p_search registers the bases of the equilibria
+// that have already been found.
+//
+// With one thread, floating-point paths are followed in B itself, and
+// the search backtracks by rolling B back to a checkpoint, so that no
+// tableau is copied.  Otherwise each path is followed in a copy of B;
+// with several threads, the paths out of an equilibrium are followed
+// in their own OpenMP tasks, and idle threads of the team take up the
+// tasks waiting to be followed, wherever they are in the search.
 //
 template <class T> void AllLemke(const StrategySupport &p_support,
 				 int j, LHTableau<T> &B,
-				 List<BFS<T> > &p_list,
+				 LemkeSearch &p_search,
 				 int depth)
 {
-  if (g_maxDepth != 0 && depth > g_maxDepth) {
+  if (g_maxDepth != 0 && depth >= g_maxDepth) {
     return;
   }
 
-  // On the initial depth=0 call, the CBFS we are at is the extraneous
-  // solution.
-  if (depth > 0 && !OnBFS(p_support, p_list, B)) {
-    return;
-  }
-  
   for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
-    if (i != j)  {
-      LHTableau<T> Bcopy(B);
-      Bcopy.LemkePath(i);
-      AllLemke(p_support, i, Bcopy, p_list, depth+1);
+    if (i == j)  continue;
+    if (g_numThreads == 1 && RollsBack(T(0))) {
+      B.Checkpoint();
+      FollowPath(p_support, i, B, p_search, depth);
+      B.Rollback();
+    }
+    else {
+#pragma omp task default(shared) firstprivate(i, depth)
+      {
+	LHTableau<T> Bcopy(B);
+	FollowPath(p_support, i, Bcopy, p_search, depth);
+      }
     }
   }
+
+  // The tasks copy B when they start, so it must outlive them
+#pragma omp taskwait
 }
 
 template <class T>
 void SolveStrategic(const Game &p_game)
 {
   StrategySupport support(p_game);
-  List<BFS<T> > bfsList;
-
-  try {
-    Matrix<T> A1 = Make_A1<T>(support);
-    Vector<T> b1 = Make_b1<T>(support);
-    Matrix<T> A2 = Make_A2<T>(support);
-    Vector<T> b2 = Make_b2<T>(support);
-    LHTableau<T> B(A1, A2, b1, b2);
-
-    if (g_stopAfter != 1) {
-      try {
-	AllLemke(support, 0, B, bfsList, 0);
-      }
-      catch (EquilibriumLimitReachedNfg &) {
-	// This pseudo-exception requires no additional action;
-	// bfsList will contain the list of equilibria found
-      }
+  if (g_eliminateMixed) {
+    support = IteratedMixedUndominated<T>(support);
+  }
+  LemkeSearch search;
+
+  Matrix<T> A1 = Make_A1<T>(support);
+  Vector<T> b1 = Make_b1<T>(support);
+  Matrix<T> A2 = Make_A2<T>(support);
+  Vector<T> b2 = Make_b2<T>(support);
+  LHTableau<T> B(A1, A2, b1, b2);
+
+  if (g_stopAfter != 1) {
+    // On the initial call, the CBFS we are at is the extraneous solution.
+    if (g_numThreads > 1) {
+      Reduce(A1);  Reduce(b1);  Reduce(A2);  Reduce(b2);
+#pragma omp parallel num_threads(g_numThreads)
+#pragma omp single
+      AllLemke(support, 0, B, search, 0);
     }
-    else  {
-      B.LemkePath(1);
-      OnBFS(support, bfsList, B);
+    else {
+      AllLemke(support, 0, B, search, 0);
+    }
+    if (search.m_failed) {
+      // One of the paths raised an exception; for now, we won't give
+      // any more solutions, although we should list any solutions found
+      throw Exception();
     }
-
-    return;
   }
-  catch (...) {
-    // for now, we won't give *any* solutions -- but we should list
-    // any solutions found!
-    throw;
+  else  {
+    B.LemkePath(1);
+    BFS<T> cbfs(B.GetBFS());
+    OnBFS(support, search, cbfs);
   }
 }
 
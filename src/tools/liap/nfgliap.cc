@@ -48,6 +48,11 @@ private:
   mutable long _nevals;
   Gambit::Game _nfg;
   mutable Gambit::MixedStrategyProfile<double> _p;
+  // Payoffs and their derivatives at the point of the last gradient
+  mutable Gambit::Array<double> _payoffs;
+  mutable Gambit::Vector<double> _values;
+  mutable Gambit::Array<Gambit::Matrix<double> > _derivs;
+  mutable Gambit::Matrix<double> _firstDerivs;
 
   double Value(const Gambit::Vector<double> &) const;
   bool Gradient(const Gambit::Vector<double> &, Gambit::Vector<double> &) const;
@@ -64,35 +69,44 @@ public:
 
 NFLiapFunc::NFLiapFunc(const Gambit::Game &N,
 		       const Gambit::MixedStrategyProfile<double> &start)
-  : _nevals(0L), _nfg(N), _p(start)
+  : _nevals(0L), _nfg(N), _p(start),
+    _payoffs(N->NumPlayers()), _values(start.MixedProfileLength()),
+    _derivs(N->NumPlayers()), 
+    _firstDerivs(N->NumPlayers(), start.MixedProfileLength())
 { }
 
 NFLiapFunc::~NFLiapFunc()
 { }
 
+//
+// This uses the payoffs and derivatives computed by Gradient() for the
+// profile p.
+//
 double NFLiapFunc::LiapDerivValue(int i1, int j1,
 				  const Gambit::MixedStrategyProfile<double> &p) const
 {
-  int i, j;
+  int i, j, ii;
   double x, x1, psum;
+
+  // index of strategy (i1, j1) in the profile
+  int col = j1;
+  for (i = 1; i < i1; i++) {
+    col += p.GetSupport().NumStrategies(i);
+  }
   
   x = 0.0;
-  for (i = 1; i <= _nfg->NumPlayers(); i++)  {
+  for (i = 1, ii = 1; i <= _nfg->NumPlayers(); i++)  {
     psum = 0.0;
-    for (j = 1; j <= p.GetSupport().NumStrategies(i); j++)  {
-      psum += p[p.GetSupport().GetStrategy(i,j)];
-      x1 = p.GetPayoff(p.GetSupport().GetStrategy(i, j)) - p.GetPayoff(i);
+    for (j = 1; j <= p.GetSupport().NumStrategies(i); j++, ii++)  {
+      psum += p[ii];
+      x1 = _values[ii] - _payoffs[i];
       if (i1 == i) {
 	if (x1 > 0.0)
-	  x -= x1 * p.GetPayoffDeriv(i, p.GetSupport().GetStrategy(i1, j1));
+	  x -= x1 * _values[col];
       }
       else {
 	if (x1> 0.0)
-	  x += x1 * (p.GetPayoffDeriv(i, 
-				      p.GetSupport().GetStrategy(i, j),
-				      p.GetSupport().GetStrategy(i1, j1)) - 
-		     p.GetPayoffDeriv(i,
-				      p.GetSupport().GetStrategy(i1, j1)));
+	  x += x1 * (_derivs[i](j, col) - _firstDerivs(i, col));
       }
     }
     if (i == i1)  x += 100.0 * (psum - 1.0);
@@ -130,6 +144,27 @@ bool NFLiapFunc::Gradient(const Gambit::Vector<double> &v, Gambit::Vector<double
 {
   ((Gambit::Vector<double> &) _p).operator=(v);
   int i1, j1, ii;
+
+  // The derivative of player i1's payoff with respect to another player's
+  // strategy is the sum of its second derivatives with respect to that
+  // strategy and each of i1's own strategies played.
+  _p.GetPayoffVector(_values);
+  for (i1 = 1, ii = 1; i1 <= _nfg->NumPlayers(); i1++) {
+    _payoffs[i1] = _p.GetPayoff(i1);
+    _derivs[i1] = Gambit::Matrix<double>(_p.GetSupport().NumStrategies(i1),
+					 _p.MixedProfileLength());
+    _p.GetPayoffDerivs(i1, _derivs[i1]);
+    for (int col = 1; col <= _p.MixedProfileLength(); col++) {
+      _firstDerivs(i1, col) = 0.0;
+    }
+    for (j1 = 1; j1 <= _p.GetSupport().NumStrategies(i1); j1++, ii++) {
+      if (_p[ii] > 0.0) {
+	for (int col = 1; col <= _p.MixedProfileLength(); col++) {
+	  _firstDerivs(i1, col) += _p[ii] * _derivs[i1](j1, col);
+	}
+      }
+    }
+  }
   
   for (i1 = 1, ii = 1; i1 <= _nfg->NumPlayers(); i1++) {
     for (j1 = 1; j1 <= _p.GetSupport().NumStrategies(i1); j1++) {
@@ -54,11 +54,12 @@ void LogitBR(const Gambit::MixedStrategyProfile<double> &p_profile, double p_lam
   Gambit::Game nfg = p_profile.GetGame();
 
   for (int pl = 1; pl <= nfg->NumPlayers(); pl++) {
-    Gambit::Array<double> lval(nfg->GetPlayer(pl)->NumStrategies());
+    Gambit::Vector<double> lval(nfg->GetPlayer(pl)->NumStrategies());
     double sum = 0.0;
 
+    p_profile.GetPayoffVector(pl, lval);
     for (int st = 1; st <= nfg->GetPlayer(pl)->NumStrategies(); st++) {
-      lval[st] = exp(p_lambda * p_profile.GetPayoff(nfg->GetPlayer(pl)->GetStrategy(st)));
+      lval[st] = exp(p_lambda * lval[st]);
       sum += lval[st];
     }
 
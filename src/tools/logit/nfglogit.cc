@@ -97,6 +97,8 @@ StrategicQREPathTracer::GetLHS(const Vector<double> &p_point, Vector<double> &p_
   int rowno = 0;
   for (int pl = 1; pl <= support.GetGame()->NumPlayers(); pl++) {
     GamePlayer player = support.GetGame()->GetPlayer(pl);
+    Vector<double> payoffs(player->NumStrategies());
+    profile.GetPayoffVector(pl, payoffs);
     for (int st = 1; st <= player->NumStrategies(); st++) {
       rowno++;
       if (st == 1) {
@@ -109,8 +111,7 @@ StrategicQREPathTracer::GetLHS(const Vector<double> &p_point, Vector<double> &p_
       else {
 	p_lhs[rowno] = (logprofile[player->GetStrategy(st)] - 
 			logprofile[player->GetStrategy(1)] -
-			lambda * (profile.GetPayoff(player->GetStrategy(st)) -
-				  profile.GetPayoff(player->GetStrategy(1))));
+			lambda * (payoffs[st] - payoffs[1]));
 
       }
     }
@@ -134,6 +135,11 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
   int rowno = 0;
   for (int i = 1; i <= support.GetGame()->NumPlayers(); i++) {
     GamePlayer player = support.GetGame()->GetPlayer(i);
+    Vector<double> payoffs(player->NumStrategies());
+    profile.GetPayoffVector(i, payoffs);
+    Matrix<double> derivs(player->NumStrategies(), 
+			  profile.MixedProfileLength());
+    profile.GetPayoffDerivs(i, derivs);
 
     for (int j = 1; j <= player->NumStrategies(); j++) {
       rowno++;
@@ -184,12 +190,7 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
 	      // 1 == sum-to-one
 	      p_matrix(colno, rowno) =
 		-lambda * profile[player2->GetStrategy(m)] *
-		(profile.GetPayoffDeriv(i, 
-					support.GetStrategy(i, j),
-					support.GetStrategy(ell, m)) -
-		 profile.GetPayoffDeriv(i, 
-					support.GetStrategy(i, 1),
-					support.GetStrategy(ell, m)));
+		(derivs(j, colno) - derivs(1, colno));
 	    }
 	  }
 
@@ -197,9 +198,7 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
 	
 	// column wrt lambda
 	// 1 == sum-to-one
-	p_matrix(p_matrix.NumRows(), rowno) =
-	  (profile.GetPayoff(support.GetStrategy(i, 1)) - 
-	   profile.GetPayoff(support.GetStrategy(i, j)));
+	p_matrix(p_matrix.NumRows(), rowno) = payoffs[1] - payoffs[j];
       }
     }
   }
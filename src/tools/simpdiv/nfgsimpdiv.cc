@@ -451,8 +451,10 @@ Gambit::Rational nfgSimpdiv::getlabel(Gambit::MixedStrategyProfile<Gambit::Ratio
     payoff=Gambit::Rational(0);
     maxval=(Gambit::Rational(-1000000));
     jj=0;
+    Gambit::Vector<Gambit::Rational> values(yy.GetSupport().NumStrategies(i));
+    yy.GetPayoffVector(i, values);
     for(j=1;j<=yy.GetSupport().NumStrategies(i);j++) {
-      pay=yy.GetPayoff(yy.GetSupport().GetStrategy(i,j));
+      pay=values[j];
       payoff+=(yy[yy.GetSupport().GetStrategy(i,j)]*pay);
       if(pay>maxval) {
 	maxval=pay;